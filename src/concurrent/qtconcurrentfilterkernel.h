@@ -175,7 +175,9 @@ public:
           keep(std::forward<Keep>(_keep)),
           reduce(std::forward<Reduce>(_reduce)),
           reducer(pool, reduceOption)
-    { }
+    {
+        this->blockSizeLimit = ReduceBlockSizeLimit;
+    }
 
     template <typename Keep = KeepFunctor, typename Reduce = ReduceFunctor>
     FilteredReducedKernel(QThreadPool *pool, Iterator begin, Iterator end, Keep &&_keep,
@@ -187,6 +189,7 @@ public:
           reduce(std::forward<Reduce>(_reduce)),
           reducer(pool, reduceOption)
     {
+        this->blockSizeLimit = ReduceBlockSizeLimit;
     }
 
     bool runIteration(Iterator it, int index, ReducedResultType *) override
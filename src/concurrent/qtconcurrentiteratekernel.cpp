@@ -103,7 +103,15 @@ namespace QtConcurrent {
 
 */
 BlockSizeManager::BlockSizeManager(QThreadPool *pool, int iterationCount)
-    : maxBlockSize(iterationCount / (pool->maxThreadCount() * 2)),
+    : BlockSizeManager(pool, iterationCount, std::numeric_limits<int>::max())
+{ }
+
+/*! \internal
+
+    Limits the block size to \a maxBlockSize iterations.
+*/
+BlockSizeManager::BlockSizeManager(QThreadPool *pool, int iterationCount, int maxBlockSize)
+    : maxBlockSize(qMin(iterationCount / (pool->maxThreadCount() * 2), maxBlockSize)),
       beforeUser(0), afterUser(0),
       m_blockSize(1)
 { }
@@ -49,6 +49,7 @@
 #include <QtConcurrent/qtconcurrentthreadengine.h>
 
 #include <iterator>
+#include <limits>
 
 QT_BEGIN_NAMESPACE
 
@@ -68,6 +69,7 @@ class Q_CONCURRENT_EXPORT BlockSizeManager
 {
 public:
     explicit BlockSizeManager(QThreadPool *pool, int iterationCount);
+    BlockSizeManager(QThreadPool *pool, int iterationCount, int maxBlockSize);
 
     void timeBeforeUser();
     void timeAfterUser();
@@ -254,7 +256,8 @@ public:
 
     ThreadFunctionResult forThreadFunction()
     {
-        BlockSizeManager blockSizeManager(ThreadEngineBase::threadPool, iterationCount);
+        BlockSizeManager blockSizeManager(ThreadEngineBase::threadPool, iterationCount,
+                                          blockSizeLimit);
         ResultReporter<T> resultReporter = createResultsReporter();
 
         for(;;) {
@@ -359,6 +362,7 @@ public:
     const bool forIteration;
     bool progressReportingEnabled;
     DefaultValueContainer<ResultType> defaultValue;
+    int blockSizeLimit = std::numeric_limits<int>::max(); // most iterations reserved at a time
 };
 
 } // namespace QtConcurrent
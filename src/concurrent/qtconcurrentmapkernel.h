@@ -110,7 +110,9 @@ public:
           map(std::forward<F1>(_map)),
           reduce(std::forward<F2>(_reduce)),
           reducer(pool, reduceOptions)
-    { }
+    {
+        this->blockSizeLimit = ReduceBlockSizeLimit;
+    }
 
     template<typename F1 = MapFunctor, typename F2 = ReduceFunctor>
     MappedReducedKernel(QThreadPool *pool, Iterator begin, Iterator end, F1 &&_map, F2 &&_reduce,
@@ -122,6 +124,7 @@ public:
           reduce(std::forward<F2>(_reduce)),
           reducer(pool, reduceOptions)
     {
+        this->blockSizeLimit = ReduceBlockSizeLimit;
     }
 
     bool runIteration(Iterator it, int index, ReducedResultType *) override
@@ -78,6 +78,18 @@ enum {
 };
 #endif
 
+/*
+    The ReduceBlockSizeLimit constant limits the number of iterations a
+    thread processes at a time for MapReduce. Together with the reduce queue
+    limits, it bounds the number of intermediate results waiting to be
+    reduced, regardless of the size of the input sequence: blocks are
+    reduced as soon as all blocks before them are, and threads are throttled
+    while too many blocks are waiting.
+*/
+enum {
+    ReduceBlockSizeLimit = 4096
+};
+
 // IntermediateResults holds a block of intermediate results from a
 // map or filter functor. The begin/end offsets indicates the origin
 // and range of the block.
@@ -192,6 +192,26 @@ eventfd_write(fd, value);
 }
 ")
 
+# epoll
+qt_config_compile_test(epoll
+    LABEL "epoll"
+    CODE
+"#include <sys/epoll.h>
+
+int main(void)
+{
+    /* BEGIN TEST: */
+struct epoll_event ev;
+int fd = epoll_create1(EPOLL_CLOEXEC);
+ev.events = EPOLLIN | EPOLLPRI;
+ev.data.fd = 0;
+epoll_ctl(fd, EPOLL_CTL_ADD, 0, &ev);
+epoll_wait(fd, &ev, 1, 0);
+    /* END TEST: */
+    return 0;
+}
+")
+
 # futimens
 qt_config_compile_test(futimens
     LABEL "futimens()"
@@ -528,6 +548,10 @@ qt_feature("eventfd" PUBLIC
     CONDITION NOT WASM AND TEST_eventfd
 )
 qt_feature_definition("eventfd" "QT_NO_EVENTFD" NEGATE VALUE "1")
+qt_feature("epoll" PRIVATE
+    LABEL "epoll event dispatcher"
+    CONDITION LINUX AND TEST_epoll
+)
 qt_feature("futimens" PRIVATE
     LABEL "futimens()"
     CONDITION NOT WIN32 AND TEST_futimens
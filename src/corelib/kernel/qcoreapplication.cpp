@@ -339,6 +339,8 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
+    const QMutexLocker locker(&currentThreadData->postEventList.mutex);
+    currentThreadData->postEventList.takeIncomingEvents();
     return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
 }
 
@@ -487,6 +489,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         const auto locker = qt_scoped_lock(thisThreadData->postEventList.mutex);
+        thisThreadData->postEventList.takeIncomingEvents();
         for (int i = 0; i < thisThreadData->postEventList.size(); ++i) {
             const QPostEvent &pe = thisThreadData->postEventList.at(i);
             if (pe.event) {
@@ -1528,6 +1531,14 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    // Queued calls at the default priority are never compressed and don't
+    // need to be sorted, so they bypass the mutex and go into the lock-free
+    // queue, which the receiving thread moves into the list.
+    if (event->type() == QEvent::MetaCall && priority == Qt::NormalEventPriority
+            && QCoreApplicationPrivate::postEventLockFree(receiver, event)) {
+        return;
+    }
+
     auto locker = QCoreApplicationPrivate::lockThreadPostEventList(receiver);
     if (!locker.threadData) {
         // posting during destruction? just delete the event to prevent a leak
@@ -1537,6 +1548,9 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     QThreadData *data = locker.threadData;
 
+    // keep the order relative to events posted without the mutex
+    data->postEventList.takeIncomingEvents();
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1585,6 +1599,47 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         dispatcher->wakeUp();
 }
 
+/*
+    Queues \a event for \a receiver without locking the post event list.
+    Returns \c false if the receiver is moving to another thread; the event
+    must then be posted the usual way.
+*/
+bool QCoreApplicationPrivate::postEventLockFree(QObject *receiver, QEvent *event)
+{
+    // QObject::moveToThread() blocks this path and waits for the posts in
+    // progress, so the thread data can't change until we are done
+    auto *d = QObjectPrivate::get(receiver);
+    if (d->lockFreePosts.fetchAndAddOrdered(1) & QObjectPrivate::LockFreePostsBlocked) {
+        d->lockFreePosts.deref();
+        return false;
+    }
+
+    QThreadData *data = d->threadData.loadAcquire();
+    if (!data) {
+        d->lockFreePosts.deref();
+        // posting during destruction? just delete the event to prevent a leak
+        delete event;
+        return true;
+    }
+
+    Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, event->type());
+    event->m_posted = true;
+    d->incomingEvents.ref();
+    data->postEventList.producers.ref();
+    // only the first event after the receiving thread took all queued events
+    // needs to wake it up
+    const bool wakeUp = data->postEventList.pushIncomingEvent(receiver, event);
+    data->postEventList.producers.deref();
+    d->lockFreePosts.deref();
+
+    if (wakeUp) {
+        QAbstractEventDispatcher* dispatcher = data->eventDispatcher.loadAcquire();
+        if (dispatcher)
+            dispatcher->wakeUp();
+    }
+    return true;
+}
+
 /*!
   \internal
   Returns \c true if \a event was compressed away (possibly deleted) and should not be added to the list.
@@ -1682,6 +1737,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     auto locker = qt_unique_lock(data->postEventList.mutex);
+    data->postEventList.takeIncomingEvents();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1836,6 +1892,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     auto locker = QCoreApplicationPrivate::lockThreadPostEventList(receiver);
     QThreadData *data = locker.threadData;
+    data->postEventList.takeIncomingEvents();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1899,6 +1956,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     const auto locker = qt_scoped_lock(data->postEventList.mutex);
+    data->postEventList.takeIncomingEvents();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
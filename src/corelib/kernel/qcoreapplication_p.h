@@ -155,6 +155,7 @@ public:
 
         void unlock() { locker.unlock(); }
     };
+    static bool postEventLockFree(QObject *receiver, QEvent *event);
     static QPostEventListLocker lockThreadPostEventList(QObject *object);
 #endif // QT_NO_QOBJECT
 
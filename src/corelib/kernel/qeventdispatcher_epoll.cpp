@@ -0,0 +1,489 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplatformdefs.h"
+
+#include "qcoreapplication.h"
+#include "qsocketnotifier.h"
+#include "qthread.h"
+
+#include "qeventdispatcher_epoll_p.h"
+#include <private/qthread_p.h>
+#include <private/qcoreapplication_p.h>
+#include <private/qcore_unix_p.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+
+QT_BEGIN_NAMESPACE
+
+static const char *socketType(QSocketNotifier::Type type)
+{
+    switch (type) {
+    case QSocketNotifier::Read:
+        return "Read";
+    case QSocketNotifier::Write:
+        return "Write";
+    case QSocketNotifier::Exception:
+        return "Exception";
+    }
+
+    Q_UNREACHABLE();
+}
+
+static quint32 epollEvents(const QSocketNotifierSetUNIX &sn_set) noexcept
+{
+    // POLLIN/POLLOUT/POLLPRI have the same values as their EPOLL counterparts,
+    // but spell them out anyway; EPOLLERR and EPOLLHUP are always reported.
+    quint32 result = 0;
+    if (sn_set.notifiers[QSocketNotifier::Read])
+        result |= EPOLLIN;
+    if (sn_set.notifiers[QSocketNotifier::Write])
+        result |= EPOLLOUT;
+    if (sn_set.notifiers[QSocketNotifier::Exception])
+        result |= EPOLLPRI;
+    return result;
+}
+
+static int timespecToEpollTimeout(const timespec *tm) noexcept
+{
+    if (!tm)
+        return -1;
+
+    // round up: waking up before the next timer is due would only make us
+    // spin with a zero timeout until it is
+    const qint64 msecs = qint64(tm->tv_sec) * 1000 + (tm->tv_nsec + 999999) / 1000000;
+    return int(qMin<qint64>(msecs, INT_MAX));
+}
+
+QEventDispatcherEpollPrivate::QEventDispatcherEpollPrivate()
+{
+    if (Q_UNLIKELY(threadPipe.init() == false))
+        qFatal("QEventDispatcherEpollPrivate(): Cannot continue without a thread pipe");
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (Q_UNLIKELY(epollFd == -1))
+        qFatal("QEventDispatcherEpollPrivate(): Cannot create epoll instance: %s",
+               qPrintable(qt_error_string(errno)));
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = threadPipe.fds[0];
+    if (Q_UNLIKELY(epoll_ctl(epollFd, EPOLL_CTL_ADD, ev.data.fd, &ev) == -1))
+        qFatal("QEventDispatcherEpollPrivate(): Cannot watch the thread pipe: %s",
+               qPrintable(qt_error_string(errno)));
+
+    readyEvents.resize(64);
+}
+
+QEventDispatcherEpollPrivate::~QEventDispatcherEpollPrivate()
+{
+    if (epollFd >= 0)
+        qt_safe_close(epollFd);
+}
+
+bool QEventDispatcherEpollPrivate::updateInterest(int fd, const QSocketNotifierSetUNIX &sn_set,
+                                                  bool isNew)
+{
+    if (alwaysReadyFds.contains(fd)) {
+        if (sn_set.isEmpty())
+            alwaysReadyFds.removeOne(fd);
+        return true;
+    }
+
+    if (sn_set.isEmpty()) {
+        // the descriptor may already have been closed, in which case the
+        // kernel has dropped it from the interest set on its own
+        return epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr) == 0;
+    }
+
+    epoll_event ev = {};
+    ev.events = epollEvents(sn_set);
+    ev.data.fd = fd;
+
+    int op = isNew ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    if (epoll_ctl(epollFd, op, fd, &ev) == 0)
+        return true;
+
+    // A descriptor that was closed and reused behind our back can be either
+    // still registered (when new) or no longer registered (when not new).
+    if (errno == EEXIST || errno == ENOENT) {
+        op = (errno == EEXIST) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+        if (epoll_ctl(epollFd, op, fd, &ev) == 0)
+            return true;
+    }
+
+    if (errno == EPERM) {
+        // regular files and the like: poll(2) reports them as always ready
+        alwaysReadyFds.append(fd);
+        return true;
+    }
+
+    return false;
+}
+
+void QEventDispatcherEpollPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+
+    if (pendingNotifiers.contains(notifier))
+        return;
+
+    pendingNotifiers << notifier;
+}
+
+int QEventDispatcherEpollPrivate::activateTimers()
+{
+    return timerList.activateTimers();
+}
+
+void QEventDispatcherEpollPrivate::markPendingSocketNotifiers(int fd, quint32 revents)
+{
+    auto it = socketNotifiers.constFind(fd);
+    if (it == socketNotifiers.cend())
+        return;
+
+    const QSocketNotifierSetUNIX &sn_set = it.value();
+
+    static const struct {
+        QSocketNotifier::Type type;
+        quint32 flags;
+    } notifiers[] = {
+        { QSocketNotifier::Read,      EPOLLIN  | EPOLLHUP | EPOLLERR },
+        { QSocketNotifier::Write,     EPOLLOUT | EPOLLHUP | EPOLLERR },
+        { QSocketNotifier::Exception, EPOLLPRI | EPOLLHUP | EPOLLERR }
+    };
+
+    for (const auto &n : notifiers) {
+        QSocketNotifier *notifier = sn_set.notifiers[n.type];
+        if (notifier && (revents & n.flags))
+            setSocketNotifierPending(notifier);
+    }
+}
+
+int QEventDispatcherEpollPrivate::activateSocketNotifiers()
+{
+    if (pendingNotifiers.isEmpty())
+        return 0;
+
+    int n_activated = 0;
+    QEvent event(QEvent::SockAct);
+
+    while (!pendingNotifiers.isEmpty()) {
+        QSocketNotifier *notifier = pendingNotifiers.takeFirst();
+        QCoreApplication::sendEvent(notifier, &event);
+        ++n_activated;
+    }
+
+    return n_activated;
+}
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QObject *parent)
+    : QAbstractEventDispatcher(*new QEventDispatcherEpollPrivate, parent)
+{ }
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QEventDispatcherEpollPrivate &dd, QObject *parent)
+    : QAbstractEventDispatcher(dd, parent)
+{ }
+
+QEventDispatcherEpoll::~QEventDispatcherEpoll()
+{ }
+
+/*!
+    \internal
+
+    Returns \c true if the QT_EVENT_DISPATCHER_EPOLL environment variable
+    asks for this dispatcher to be used instead of the default one.
+*/
+bool QEventDispatcherEpoll::isRequested()
+{
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL", &ok);
+    return ok && value > 0;
+}
+
+/*!
+    \internal
+*/
+void QEventDispatcherEpoll::registerTimer(int timerId, qint64 interval, Qt::TimerType timerType, QObject *obj)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1 || interval < 0 || !obj) {
+        qWarning("QEventDispatcherEpoll::registerTimer: invalid arguments");
+        return;
+    } else if (obj->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::registerTimer: timers cannot be started from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    d->timerList.registerTimer(timerId, interval, timerType, obj);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimer(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: invalid argument");
+        return false;
+    } else if (thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimer(timerId);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimers(QObject *object)
+{
+#ifndef QT_NO_DEBUG
+    if (!object) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: invalid argument");
+        return false;
+    } else if (object->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimers(object);
+}
+
+QList<QEventDispatcherEpoll::TimerInfo>
+QEventDispatcherEpoll::registeredTimers(QObject *object) const
+{
+    if (!object) {
+        qWarning("QEventDispatcherEpoll:registeredTimers: invalid argument");
+        return QList<TimerInfo>();
+    }
+
+    Q_D(const QEventDispatcherEpoll);
+    return d->timerList.registeredTimers(object);
+}
+
+void QEventDispatcherEpoll::registerSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be enabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    const bool isNew = !d->socketNotifiers.contains(sockfd);
+    QSocketNotifierSetUNIX &sn_set = d->socketNotifiers[sockfd];
+
+    if (sn_set.notifiers[type] && sn_set.notifiers[type] != notifier)
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+
+    sn_set.notifiers[type] = notifier;
+
+    if (!d->updateInterest(sockfd, sn_set, isNew))
+        qWarning("QSocketNotifier: Invalid socket %d with type %s, epoll_ctl failed: %s",
+                 sockfd, socketType(type), qPrintable(qt_error_string(errno)));
+}
+
+void QEventDispatcherEpoll::unregisterSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifier (fd %d) cannot be disabled from another thread.", sockfd);
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+
+    d->pendingNotifiers.removeOne(notifier);
+
+    auto i = d->socketNotifiers.find(sockfd);
+    if (i == d->socketNotifiers.end())
+        return;
+
+    QSocketNotifierSetUNIX &sn_set = i.value();
+
+    if (sn_set.notifiers[type] == nullptr)
+        return;
+
+    if (sn_set.notifiers[type] != notifier) {
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+        return;
+    }
+
+    sn_set.notifiers[type] = nullptr;
+
+    // failures are expected here: the socket is typically closed already
+    d->updateInterest(sockfd, sn_set, false);
+
+    if (sn_set.isEmpty())
+        d->socketNotifiers.erase(i);
+}
+
+bool QEventDispatcherEpoll::processEvents(QEventLoop::ProcessEventsFlags flags)
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.storeRelaxed(0);
+
+    // we are awake, broadcast it
+    emit awake();
+
+    auto threadData = d->threadData.loadRelaxed();
+    QCoreApplicationPrivate::sendPostedEvents(nullptr, 0, threadData);
+
+    const bool include_timers = (flags & QEventLoop::X11ExcludeTimers) == 0;
+    const bool include_notifiers = (flags & QEventLoop::ExcludeSocketNotifiers) == 0;
+    const bool wait_for_events = flags & QEventLoop::WaitForMoreEvents;
+
+    const bool canWait = (threadData->canWaitLocked()
+                          && !d->interrupt.loadRelaxed()
+                          && wait_for_events
+                          && (!include_notifiers || d->alwaysReadyFds.isEmpty()));
+
+    if (canWait)
+        emit aboutToBlock();
+
+    if (d->interrupt.loadRelaxed())
+        return false;
+
+    int nevents = 0;
+
+    for (;;) {
+        timespec *tm = nullptr;
+        timespec wait_tm = { 0, 0 };
+
+        if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
+            tm = &wait_tm;
+
+        if (!include_notifiers) {
+            // The interest set always contains every socket notifier, so a ready
+            // but excluded socket would keep epoll_wait() from blocking. Wait for
+            // the thread pipe alone instead, like QEventDispatcherUNIX does.
+            pollfd pfd = d->threadPipe.prepare();
+            if (qt_safe_poll(&pfd, 1, tm) > 0)
+                nevents += d->threadPipe.check(pfd);
+        } else {
+            const int ready = epoll_wait(d->epollFd, d->readyEvents.data(), d->readyEvents.size(),
+                                         timespecToEpollTimeout(tm));
+            if (ready == -1 && errno != EINTR)
+                perror("epoll_wait");
+
+            for (int i = 0; i < ready; ++i) {
+                const epoll_event &ev = d->readyEvents.at(i);
+                if (ev.data.fd == d->threadPipe.fds[0]) {
+                    pollfd pfd = d->threadPipe.prepare();
+                    pfd.revents = POLLIN;
+                    nevents += d->threadPipe.check(pfd);
+                } else {
+                    d->markPendingSocketNotifiers(ev.data.fd, ev.events);
+                }
+            }
+
+            // a full buffer means more descriptors may be ready than we asked
+            // for; grow it so the next iteration can pick them all up at once
+            if (ready == d->readyEvents.size() && ready <= d->socketNotifiers.size())
+                d->readyEvents.resize(ready * 2);
+
+            for (int fd : qAsConst(d->alwaysReadyFds))
+                d->markPendingSocketNotifiers(fd, EPOLLIN | EPOLLOUT);
+            nevents += d->activateSocketNotifiers();
+        }
+
+        if (include_timers)
+            nevents += d->activateTimers();
+
+        // The timer wheel wakes us up early when it needs to move timers
+        // to finer buckets; keep waiting if that is all that happened.
+        const bool sleptForTimer = tm && (tm->tv_sec || tm->tv_nsec);
+        if (nevents || !canWait || !sleptForTimer || d->interrupt.loadRelaxed())
+            break;
+    }
+
+    // return true if we handled events, false otherwise
+    return (nevents > 0);
+}
+
+int QEventDispatcherEpoll::remainingTime(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::remainingTime: invalid argument");
+        return -1;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.timerRemainingTime(timerId);
+}
+
+void QEventDispatcherEpoll::wakeUp()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->threadPipe.wakeUp();
+}
+
+void QEventDispatcherEpoll::interrupt()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.storeRelaxed(1);
+    wakeUp();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qeventdispatcher_epoll_p.cpp"
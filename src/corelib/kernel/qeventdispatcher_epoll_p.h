@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QEVENTDISPATCHER_EPOLL_P_H
+#define QEVENTDISPATCHER_EPOLL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "QtCore/qabstracteventdispatcher.h"
+#include "QtCore/qlist.h"
+#include "private/qabstracteventdispatcher_p.h"
+#include "private/qeventdispatcher_unix_p.h"
+
+#include <sys/epoll.h>
+
+QT_REQUIRE_CONFIG(epoll);
+
+QT_BEGIN_NAMESPACE
+
+class QEventDispatcherEpollPrivate;
+
+// Linux-only alternative to QEventDispatcherUNIX. Instead of rebuilding a
+// pollfd array for every registered socket notifier on each loop iteration,
+// the interest set is kept in the kernel and only updated when a notifier is
+// (un)registered, so that the cost of one iteration depends on the number of
+// ready file descriptors rather than on the number of registered ones.
+// Timers are kept in a QTimerWheel for the same reason.
+class Q_CORE_EXPORT QEventDispatcherEpoll : public QAbstractEventDispatcher
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QEventDispatcherEpoll)
+
+public:
+    explicit QEventDispatcherEpoll(QObject *parent = nullptr);
+    ~QEventDispatcherEpoll();
+
+    static bool isRequested();
+
+    bool processEvents(QEventLoop::ProcessEventsFlags flags) override;
+
+    void registerSocketNotifier(QSocketNotifier *notifier) final;
+    void unregisterSocketNotifier(QSocketNotifier *notifier) final;
+
+    void registerTimer(int timerId, qint64 interval, Qt::TimerType timerType, QObject *object) final;
+    bool unregisterTimer(int timerId) final;
+    bool unregisterTimers(QObject *object) final;
+    QList<TimerInfo> registeredTimers(QObject *object) const final;
+
+    int remainingTime(int timerId) final;
+
+    void wakeUp() override;
+    void interrupt() final;
+
+protected:
+    QEventDispatcherEpoll(QEventDispatcherEpollPrivate &dd, QObject *parent = nullptr);
+};
+
+class Q_CORE_EXPORT QEventDispatcherEpollPrivate : public QAbstractEventDispatcherPrivate
+{
+    Q_DECLARE_PUBLIC(QEventDispatcherEpoll)
+
+public:
+    QEventDispatcherEpollPrivate();
+    ~QEventDispatcherEpollPrivate();
+
+    int activateTimers();
+
+    bool updateInterest(int fd, const QSocketNotifierSetUNIX &sn_set, bool isNew);
+    void markPendingSocketNotifiers(int fd, quint32 revents);
+    int activateSocketNotifiers();
+    void setSocketNotifierPending(QSocketNotifier *notifier);
+
+    int epollFd = -1;
+    QThreadPipe threadPipe;
+    QList<epoll_event> readyEvents;
+
+    QHash<int, QSocketNotifierSetUNIX> socketNotifiers;
+    // fds that epoll refuses to watch (regular files, some character
+    // devices); poll(2) always reports them ready, so do we
+    QList<int> alwaysReadyFds;
+    QList<QSocketNotifier *> pendingNotifiers;
+
+    QTimerWheel timerList;
+    QAtomicInt interrupt; // bool
+};
+
+QT_END_NAMESPACE
+
+#endif // QEVENTDISPATCHER_EPOLL_P_H
@@ -223,7 +223,7 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    if (postedEvents || incomingEvents.loadAcquire())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     thisThreadData->deref();
@@ -1566,6 +1566,10 @@ void QObject::moveToThread(QThread *targetThread)
     if (!targetData)
         targetData = new QThreadData(0);
 
+    // events for the objects being moved that are posted without locking the
+    // post event list must be in the list before we move them
+    d->blockLockFreePosts_helper(true);
+
     // make sure nobody adds/removes connections to this object while we're moving it
     QMutexLocker l(signalSlotLock(this));
 
@@ -1576,9 +1580,11 @@ void QObject::moveToThread(QThread *targetThread)
     currentData->ref();
 
     // move the object
+    currentData->postEventList.takeIncomingEvents();
     d_func()->setThreadData_helper(currentData, targetData);
 
     locker.unlock();
+    d->blockLockFreePosts_helper(false);
 
     // now currentData can commit suicide if it wants to
     currentData->deref();
@@ -1595,6 +1601,25 @@ void QObjectPrivate::moveToThread_helper()
     }
 }
 
+/*
+    Makes QCoreApplication::postEvent() lock the post event list for this
+    object and its children, and waits for the posts that are queueing events
+    without the lock, or allows those again if \a block is \c false. Only the
+    posts already in progress are waited for, and the list is not locked.
+*/
+void QObjectPrivate::blockLockFreePosts_helper(bool block)
+{
+    if (block) {
+        lockFreePosts.fetchAndOrOrdered(LockFreePostsBlocked);
+        while (lockFreePosts.loadAcquire() != LockFreePostsBlocked)
+            QThread::yieldCurrentThread();
+    } else {
+        lockFreePosts.fetchAndAndOrdered(~LockFreePostsBlocked);
+    }
+    for (int i = 0; i < children.size(); ++i)
+        children.at(i)->d_func()->blockLockFreePosts_helper(block);
+}
+
 void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData *targetData)
 {
     Q_Q(QObject);
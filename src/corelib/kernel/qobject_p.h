@@ -316,6 +316,7 @@ public:
 
     void setParent_helper(QObject *);
     void moveToThread_helper();
+    void blockLockFreePosts_helper(bool block);
     void setThreadData_helper(QThreadData *currentData, QThreadData *targetData);
     void _q_reregisterTimers(void *pointer);
 
@@ -378,6 +379,15 @@ public:
     // not thread-safe, so synchronization should not be necessary there.
     QAtomicPointer<QThreadData> threadData; // id of the thread that owns the object
 
+    // number of QCoreApplication::postEvent() calls queueing an event for this
+    // object without locking the post event list; LockFreePostsBlocked is set
+    // while the object moves to another thread
+    enum { LockFreePostsBlocked = 0x40000000 };
+    QAtomicInt lockFreePosts;
+    // number of events queued for this object without locking the post event
+    // list that were not moved into it yet, see postedEvents
+    QAtomicInt incomingEvents;
+
     using ConnectionDataPointer = QExplicitlySharedDataPointer<ConnectionData>;
     QAtomicPointer<ConnectionData> connections;
 
@@ -439,18 +439,12 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     return -1;
 }
 
-void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType timerType, QObject *object)
+static void calculateFirstTimeout(QTimerInfo *t, timespec currentTime)
 {
-    QTimerInfo *t = new QTimerInfo;
-    t->id = timerId;
-    t->interval = interval;
-    t->timerType = timerType;
-    t->obj = object;
-    t->activateRef = nullptr;
+    const qint64 interval = t->interval;
+    timespec expected = currentTime + interval;
 
-    timespec expected = updateCurrentTime() + interval;
-
-    switch (timerType) {
+    switch (t->timerType) {
     case Qt::PreciseTimer:
         // high precision timer is based on millisecond precision
         // so no adjustment is necessary
@@ -488,11 +482,22 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
         if (currentTime.tv_nsec > 500*1000*1000)
             ++t->timeout.tv_sec;
     }
+}
+
+void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType timerType, QObject *object)
+{
+    QTimerInfo *t = new QTimerInfo;
+    t->id = timerId;
+    t->interval = interval;
+    t->timerType = timerType;
+    t->obj = object;
+    t->activateRef = nullptr;
 
+    calculateFirstTimeout(t, updateCurrentTime());
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
-    t->expected = expected;
+    t->expected = currentTime + interval;
     t->cumulativeError = 0;
     t->count = 0;
     if (t->timerType != Qt::PreciseTimer)
@@ -651,4 +656,371 @@ int QTimerInfoList::activateTimers()
     return n_act;
 }
 
+/*
+  QTimerWheel
+
+  Timers are sorted by the tick (millisecond since origin) their timeout
+  falls into. Level 0 has one slot per tick of the current block
+  of 64 ticks; level n has one slot per block of 64^n ticks within the
+  current block of 64^(n+1) ticks. Timers beyond the top level are kept in
+  an overflow list. Whenever processing crosses into a new block, the
+  timers of the corresponding slot are redistributed to finer levels
+  ("cascading"). A bitmap per level allows skipping empty slots.
+*/
+
+struct QTimerWheel::Entry : QTimerInfo
+{
+    qint64 expiry;  // in ticks
+    Entry *prev;
+    Entry *next;
+    Entry *objectPrev; // timers of the same object
+    Entry *objectNext;
+    Slot *slot;     // null while the timer is being activated
+    int level;
+    int index;
+};
+
+QTimerWheel::QTimerWheel()
+{
+    origin = qt_gettime();
+    currentTime = origin;
+}
+
+QTimerWheel::~QTimerWheel()
+{
+    qDeleteAll(timers);
+}
+
+timespec QTimerWheel::updateCurrentTime()
+{
+    return (currentTime = qt_gettime());
+}
+
+qint64 QTimerWheel::tickFor(const timespec &t) const
+{
+    const timespec delta = t - origin;
+    return qint64(delta.tv_sec) * 1000 + delta.tv_nsec / 1000000;
+}
+
+timespec QTimerWheel::timeFor(qint64 tick) const
+{
+    timespec t = origin;
+    t.tv_sec += tick / 1000;
+    t.tv_nsec += (tick % 1000) * 1000 * 1000;
+    return normalizedTimespec(t);
+}
+
+QTimerWheel::Slot *QTimerWheel::slotFor(int level, int index)
+{
+    if (level == ExpiredLevel)
+        return &expired;
+    if (level == OverflowLevel)
+        return &overflow;
+    return &wheel[level][index];
+}
+
+void QTimerWheel::link(Entry *e, int level, int index)
+{
+    Slot *slot = slotFor(level, index);
+    e->slot = slot;
+    e->level = level;
+    e->index = index;
+    e->next = nullptr;
+    e->prev = slot->last;
+    if (slot->last)
+        slot->last->next = e;
+    else
+        slot->first = e;
+    slot->last = e;
+
+    if (level >= 0 && level < LevelCount)
+        occupied[level] |= quint64(1) << index;
+}
+
+void QTimerWheel::unlink(Entry *e)
+{
+    Slot *slot = e->slot;
+    Q_ASSERT(slot);
+    if (e->prev)
+        e->prev->next = e->next;
+    else
+        slot->first = e->next;
+    if (e->next)
+        e->next->prev = e->prev;
+    else
+        slot->last = e->prev;
+
+    if (!slot->first && e->level >= 0 && e->level < LevelCount)
+        occupied[e->level] &= ~(quint64(1) << e->index);
+
+    e->slot = nullptr;
+    e->prev = e->next = nullptr;
+}
+
+void QTimerWheel::place(Entry *e)
+{
+    // overdue timers are due in the current tick
+    e->expiry = qMax(e->expiry, current);
+
+    for (int level = 0; level < LevelCount; ++level) {
+        const int blockShift = (level + 1) * LevelBits;
+        if ((e->expiry >> blockShift) == (current >> blockShift)) {
+            link(e, level, (e->expiry >> (level * LevelBits)) & (SlotCount - 1));
+            return;
+        }
+    }
+    link(e, OverflowLevel, 0);
+}
+
+void QTimerWheel::setCurrent(qint64 tick)
+{
+    Q_ASSERT(tick > current);
+    current = tick;
+
+    // redistribute the slots whose block we just entered, coarsest first
+    for (int level = LevelCount; level > 0; --level) {
+        const int shift = level * LevelBits;
+        if (current & ((qint64(1) << shift) - 1))
+            continue;
+        Slot *slot = level == OverflowLevel
+                ? &overflow
+                : &wheel[level][(current >> shift) & (SlotCount - 1)];
+        Entry *e = slot->first;
+        while (e) {
+            Entry *next = e->next;
+            unlink(e);
+            place(e);
+            e = next;
+        }
+    }
+}
+
+// Returns the next tick at which something is due: either timers expire
+// (level 0) or a slot needs to be cascaded. Returns -1 if there are no timers.
+qint64 QTimerWheel::nextEventTick() const
+{
+    for (int level = 0; level < LevelCount; ++level) {
+        const int shift = level * LevelBits;
+        // level 0 may hold timers due at the current tick itself,
+        // the other levels only hold timers of later blocks
+        const int first = int((current >> shift) & (SlotCount - 1)) + (level ? 1 : 0);
+        if (first >= SlotCount)
+            continue;
+        const quint64 mask = occupied[level] & (~quint64(0) << first);
+        if (!mask)
+            continue;
+        // each level only holds timers due before those of the next level
+        const qint64 blockStart = (current >> (shift + LevelBits)) << (shift + LevelBits);
+        return blockStart + (qint64(qCountTrailingZeroBits(mask)) << shift);
+    }
+
+    if (overflow.first) {
+        const int shift = LevelCount * LevelBits;
+        return ((current >> shift) + 1) << shift;
+    }
+    return -1;
+}
+
+// Moves all timers of the ticks before \a now to the expired list. The
+// timers of tick \a now itself are only partially due, see activateTimers().
+void QTimerWheel::advance(qint64 now)
+{
+    while (current < now) {
+        Slot &slot = wheel[0][current & (SlotCount - 1)];
+        while (Entry *e = slot.first) {
+            unlink(e);
+            link(e, ExpiredLevel, 0);
+        }
+
+        const qint64 next = nextEventTick();
+        setCurrent((next == -1 || next > now) ? now : next);
+    }
+}
+
+void QTimerWheel::removeEntry(Entry *e)
+{
+    timers.remove(e->id);
+    if (e->objectPrev)
+        e->objectPrev->objectNext = e->objectNext;
+    else if (e->objectNext)
+        objectTimers[e->obj] = e->objectNext;
+    else
+        objectTimers.remove(e->obj);
+    if (e->objectNext)
+        e->objectNext->objectPrev = e->objectPrev;
+    if (e->slot)
+        unlink(e);
+    if (e->activateRef)
+        *(e->activateRef) = nullptr;
+    delete e;
+}
+
+bool QTimerWheel::timerWait(timespec &tm)
+{
+    updateCurrentTime();
+
+    const qint64 next = expired.first ? current : nextEventTick();
+    if (next == -1)
+        return false;
+
+    // no time to wait
+    tm.tv_sec = 0;
+    tm.tv_nsec = 0;
+
+    const qint64 now = tickFor(currentTime);
+    if (next < now || expired.first)
+        return true;
+
+    // wake up for the earliest timeout within the tick when timers are due
+    // in it, otherwise at its beginning to cascade the next slot
+    timespec timeout = timeFor(next);
+    const Slot &slot = wheel[0][next & (SlotCount - 1)];
+    if ((next >> LevelBits) == (current >> LevelBits) && slot.first) {
+        timeout = slot.first->timeout;
+        for (const Entry *e = slot.first->next; e; e = e->next) {
+            if (e->timeout < timeout)
+                timeout = e->timeout;
+        }
+    }
+
+    if (currentTime < timeout)
+        tm = timeout - currentTime;
+    return true;
+}
+
+int QTimerWheel::timerRemainingTime(int timerId)
+{
+    const Entry *t = timers.value(timerId);
+    if (!t) {
+#ifndef QT_NO_DEBUG
+        qWarning("QTimerWheel::timerRemainingTime: timer id %i not found", timerId);
+#endif
+        return -1;
+    }
+
+    updateCurrentTime();
+    if (currentTime < t->timeout) {
+        // time to wait
+        const timespec tm = roundToMillisecond(t->timeout - currentTime);
+        return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+    }
+    return 0;
+}
+
+void QTimerWheel::registerTimer(int timerId, qint64 interval, Qt::TimerType timerType, QObject *object)
+{
+    Entry *t = new Entry;
+    t->id = timerId;
+    t->interval = interval;
+    t->timerType = timerType;
+    t->obj = object;
+    t->activateRef = nullptr;
+    t->slot = nullptr;
+
+    calculateFirstTimeout(t, updateCurrentTime());
+
+    // an empty wheel can jump to the present instead of catching up later
+    const qint64 now = tickFor(currentTime);
+    if (timers.isEmpty() && !expired.first && now > current)
+        current = now;
+
+    timers.insert(timerId, t);
+    Entry *&first = objectTimers[object];
+    t->objectPrev = nullptr;
+    t->objectNext = first;
+    if (first)
+        first->objectPrev = t;
+    first = t;
+
+    t->expiry = tickFor(t->timeout);
+    place(t);
+}
+
+bool QTimerWheel::unregisterTimer(int timerId)
+{
+    Entry *t = timers.value(timerId);
+    if (!t)
+        return false;
+    removeEntry(t);
+    return true;
+}
+
+bool QTimerWheel::unregisterTimers(QObject *object)
+{
+    if (timers.isEmpty())
+        return false;
+    Entry *t = objectTimers.value(object);
+    while (t) {
+        Entry *next = t->objectNext;
+        removeEntry(t);
+        t = next;
+    }
+    return true;
+}
+
+QList<QAbstractEventDispatcher::TimerInfo> QTimerWheel::registeredTimers(QObject *object) const
+{
+    QList<QAbstractEventDispatcher::TimerInfo> list;
+    for (const Entry *t = objectTimers.value(object); t; t = t->objectNext) {
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
+    }
+    return list;
+}
+
+/*
+    Activate pending timers, returning how many where activated.
+*/
+int QTimerWheel::activateTimers()
+{
+    if (qt_disable_lowpriority_timers || timers.isEmpty())
+        return 0; // nothing to do
+
+    int n_act = 0;
+    updateCurrentTime();
+    const qint64 now = tickFor(currentTime);
+    advance(now);
+
+    // of the timers in the current tick, only take those already due
+    Q_ASSERT(current == now);
+    Slot &slot = wheel[0][now & (SlotCount - 1)];
+    for (Entry *e = slot.first; e; ) {
+        Entry *next = e->next;
+        if (!(currentTime < e->timeout)) {
+            unlink(e);
+            link(e, ExpiredLevel, 0);
+        }
+        e = next;
+    }
+
+    // Timers being activated are taken out of the wheel and only reinserted
+    // once their event has been delivered, so that a nested event loop
+    // neither waits for nor fires them again.
+    while (Entry *e = expired.first) {
+        unlink(e);
+        calculateNextTimeout(e, currentTime);
+        if (e->interval > 0)
+            n_act++;
+
+        QTimerInfo *currentTimerInfo = e;
+        e->activateRef = &currentTimerInfo;
+
+        QTimerEvent event(e->id);
+        QCoreApplication::sendEvent(e->obj, &event);
+
+        // the event handler may have unregistered the timer, which clears
+        // currentTimerInfo; if it did not, put it back into the wheel
+        if (currentTimerInfo) {
+            e->activateRef = nullptr;
+            e->expiry = tickFor(e->timeout);
+            place(e);
+        }
+    }
+
+    return n_act;
+}
+
 QT_END_NAMESPACE
@@ -56,6 +56,7 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -114,6 +115,72 @@ public:
     int activateTimers();
 };
 
+// Hierarchical timing wheel offering the same interface as QTimerInfoList.
+// Timers are kept in buckets of growing granularity (1 ms, 64 ms, 4 s, ...)
+// and moved to finer ones as their timeout approaches, so registering,
+// unregistering and activating a timer do not depend on the number of
+// timers. Requires a monotonic clock.
+class Q_CORE_EXPORT QTimerWheel
+{
+    Q_DISABLE_COPY(QTimerWheel)
+
+    enum {
+        LevelBits = 6,
+        SlotCount = 1 << LevelBits,
+        LevelCount = 5,
+        OverflowLevel = LevelCount,
+        ExpiredLevel = -1
+    };
+
+    struct Entry;
+    struct Slot {
+        Entry *first = nullptr;
+        Entry *last = nullptr;
+    };
+
+    timespec origin;
+    qint64 current = 0; // first tick, in ms since origin, not processed yet
+
+    Slot wheel[LevelCount][SlotCount];
+    quint64 occupied[LevelCount] = {};
+    Slot overflow;
+    Slot expired;
+
+    QHash<int, Entry *> timers;
+    QHash<QObject *, Entry *> objectTimers; // first timer of each object
+
+    qint64 tickFor(const timespec &t) const;
+    timespec timeFor(qint64 tick) const;
+    Slot *slotFor(int level, int index);
+    void link(Entry *e, int level, int index);
+    void unlink(Entry *e);
+    void place(Entry *e);
+    void setCurrent(qint64 tick);
+    qint64 nextEventTick() const;
+    void advance(qint64 now);
+    void removeEntry(Entry *e);
+
+public:
+    QTimerWheel();
+    ~QTimerWheel();
+
+    bool isEmpty() const { return timers.isEmpty(); }
+
+    timespec currentTime;
+    timespec updateCurrentTime();
+
+    bool timerWait(timespec &);
+
+    int timerRemainingTime(int timerId);
+
+    void registerTimer(int timerId, qint64 interval, Qt::TimerType timerType, QObject *object);
+    bool unregisterTimer(int timerId);
+    bool unregisterTimers(QObject *object);
+    QList<QAbstractEventDispatcher::TimerInfo> registeredTimers(QObject *object) const;
+
+    int activateTimers();
+};
+
 QT_END_NAMESPACE
 
 #endif // QTIMERINFO_UNIX_P_H
@@ -52,6 +52,7 @@
 #endif
 
 #include <qendian.h>
+#include <qfile.h>
 #include <qlocale.h>
 #include <private/qbytearray_p.h>
 #include <private/qnumeric_p.h>
@@ -770,7 +771,7 @@ static QCborValue::Type convertToExtendedType(QCborContainerPrivate *d)
 {
     qint64 tag = d->elements.at(0).value;
     auto &e = d->elements[1];
-    const ByteData *b = d->byteData(e);
+    const ByteDataView b = d->byteData(e);
 
     auto replaceByteData = [&](const char *buf, qsizetype len, Element::ValueFlags f) {
         d->data.clear();
@@ -938,6 +939,46 @@ void QCborContainerPrivate::compact(qsizetype reserved)
     Q_UNUSED(reserved);
 }
 
+namespace {
+struct MappedFile : public QtCbor::ExternalData
+{
+    QFile file;
+    QByteArray contents;    // used if the file can't be mapped
+};
+}
+
+/*!
+  \internal
+
+  Returns the contents of \a fileName as an ExternalData buffer suitable for
+  parsing in place, or \nullptr if the file can't be read. Regular files are
+  memory-mapped and remain mapped for as long as the buffer is referenced;
+  anything else (pipes, empty files) is read into memory.
+*/
+QtCbor::ExternalData *QtCbor::mapFile(const QString &fileName)
+{
+    auto d = std::make_unique<MappedFile>();
+    d->file.setFileName(fileName);
+    if (!d->file.open(QIODevice::ReadOnly))
+        return nullptr;
+
+    const qint64 size = d->file.size();
+    uchar *map = nullptr;
+    if (size > 0 && size <= MaxByteArraySize)
+        map = d->file.map(0, size);
+    if (map) {
+        d->begin = reinterpret_cast<const char *>(map);
+        d->size = size;
+    } else {
+        d->contents = d->file.readAll();
+        if (d->file.error() != QFileDevice::NoError)
+            return nullptr;
+        d->begin = d->contents.constData();
+        d->size = d->contents.size();
+    }
+    return d.release();
+}
+
 QCborContainerPrivate *QCborContainerPrivate::clone(QCborContainerPrivate *d, qsizetype reserved)
 {
     if (!d) {
@@ -1011,9 +1052,10 @@ void QCborContainerPrivate::replaceAt_complex(Element &e, const QCborValue &valu
     } else {
         // String data, copy contents
         e = value.container->elements.at(value.n);
+        e.flags &= ~Element::ByteDataIsExternal;
 
         // Copy string data, if any
-        if (const ByteData *b = value.container->byteData(value.n)) {
+        if (const ByteDataView b = value.container->byteData(value.n)) {
             if (this == value.container)
                 e.value = addByteData(b->toByteArray(), b->len);
             else
@@ -1050,10 +1092,16 @@ QCborValue QCborContainerPrivate::extractAt_complex(Element e)
     auto b = byteData(e);
     auto container = new QCborContainerPrivate;
 
-    if (b->len + qsizetype(sizeof(*b)) < data.size() / 4) {
+    if (e.flags & Element::ByteDataIsExternal) {
+        // refer to the same external buffer
+        container->external = external;
+        container->appendExternalByteData(b->byte(), b->len, e.type,
+                                          e.flags & ~Element::ByteDataIsExternal);
+        usedData -= b->len + qsizetype(sizeof(ByteData));
+    } else if (b->len + qsizetype(sizeof(ByteData)) < data.size() / 4) {
         // make a shallow copy of the byte data
         container->appendByteData(b->byte(), b->len, e.type, e.flags);
-        usedData -= b->len + qsizetype(sizeof(*b));
+        usedData -= b->len + qsizetype(sizeof(ByteData));
         compact(elements.size());
     } else {
         // just share with the original byte data
@@ -1122,8 +1170,8 @@ static int compareElementRecursive(const QCborContainerPrivate *c1, const Elemen
                                 e2.flags & Element::IsContainer ? e2.container : nullptr);
 
     // string data?
-    const ByteData *b1 = c1 ? c1->byteData(e1) : nullptr;
-    const ByteData *b2 = c2 ? c2->byteData(e2) : nullptr;
+    const ByteDataView b1 = c1 ? c1->byteData(e1) : ByteDataView();
+    const ByteDataView b2 = c2 ? c2->byteData(e2) : ByteDataView();
     if (b1 || b2) {
         auto len1 = b1 ? b1->len : 0;
         auto len2 = b2 ? b2->len : 0;
@@ -1169,7 +1217,7 @@ static int compareElementRecursive(const QCborContainerPrivate *c1, const Elemen
             // Case 2: one of them is UTF-8 and the other is UTF-16, so lengths
             // are NOT comparable. We need to convert to UTF-16 first...
             // (we can't use QUtf8::compareUtf8 because we need to compare lengths)
-            auto string = [](const Element &e, const ByteData *b) {
+            auto string = [](const Element &e, ByteDataView b) {
                 return e.flags & Element::StringIsUtf16 ? b->asQStringRaw() : b->toUtf8String();
             };
 
@@ -1366,7 +1414,7 @@ static void encodeToCbor(QCborStreamWriter &writer, const QCborContainerPrivate
     } else {
         // just one element
         auto e = d->elements.at(idx);
-        const ByteData *b = d->byteData(idx);
+        const ByteDataView b = d->byteData(idx);
         switch (e.type) {
         case QCborValue::Integer:
             return writer.append(qint64(e.value));
@@ -1481,7 +1529,8 @@ static Element decodeBasicValueFromCbor(QCborStreamReader &reader)
     return e;
 }
 
-static inline QCborContainerPrivate *createContainerFromCbor(QCborStreamReader &reader, int remainingRecursionDepth)
+static inline QCborContainerPrivate *createContainerFromCbor(QCborStreamReader &reader, int remainingRecursionDepth,
+                                                             QtCbor::ExternalData *external)
 {
     if (Q_UNLIKELY(remainingRecursionDepth == 0)) {
         QCborContainerPrivate::setErrorInReader(reader, { QCborError::NestingTooDeep });
@@ -1506,6 +1555,8 @@ static inline QCborContainerPrivate *createContainerFromCbor(QCborStreamReader &
         d = new QCborContainerPrivate;
         d->ref.storeRelaxed(1);
     }
+    if (d)
+        d->external = external;
 
     reader.enterContainer();
     if (reader.lastError() != QCborError::NoError)
@@ -1520,7 +1571,8 @@ static inline QCborContainerPrivate *createContainerFromCbor(QCborStreamReader &
     return d;
 }
 
-static QCborValue taggedValueFromCbor(QCborStreamReader &reader, int remainingRecursionDepth)
+static QCborValue taggedValueFromCbor(QCborStreamReader &reader, int remainingRecursionDepth,
+                                      QtCbor::ExternalData *external)
 {
     if (Q_UNLIKELY(remainingRecursionDepth == 0)) {
         QCborContainerPrivate::setErrorInReader(reader, { QCborError::NestingTooDeep });
@@ -1528,6 +1580,7 @@ static QCborValue taggedValueFromCbor(QCborStreamReader &reader, int remainingRe
     }
 
     auto d = new QCborContainerPrivate;
+    d->external = external;
     d->append(reader.toTag());
     reader.next();
 
@@ -1575,6 +1628,35 @@ void QCborContainerPrivate::decodeStringFromCbor(QCborStreamReader &reader)
 
     Element e = {};
     e.type = (reader.isByteArray() ? QCborValue::ByteArray : QCborValue::String);
+    if (external && reader.isLengthKnown() && len >= QtCbor::MinimumExternalByteDataSize) {
+        // The reader is decoding the external buffer itself, so refer to the
+        // contents of this (single-chunk) string instead of copying them.
+        char dummy;
+        if (reader.readStringChunk(&dummy, 0).status != QCborStreamReader::Ok)
+            return;
+
+        const qint64 end = reader.currentOffset();
+        Q_ASSERT(end >= len && end <= external->size);
+        const char *ptr = external->begin + end - len;
+        if (e.type == QCborValue::String) {
+            auto utf8result = QUtf8::isValidUtf8(QByteArrayView(ptr, len));
+            if (!utf8result.isValidUtf8) {
+                setErrorInReader(reader, { QCborError::InvalidUtf8String });
+                return;
+            }
+            if (utf8result.isValidAscii)
+                e.flags = Element::StringIsAscii;
+            if (Q_UNLIKELY(len > MaxStringSize)) {
+                setErrorInReader(reader, { QCborError::DataTooLarge });
+                return;
+            }
+        }
+
+        if (reader.readStringChunk(&dummy, 0).status == QCborStreamReader::EndOfString)
+            appendExternalByteData(ptr, len, e.type, e.flags);
+        return;
+    }
+
     if (len || !reader.isLengthKnown()) {
         // The use of size_t means none of the operations here can overflow because
         // all inputs are less than half SIZE_MAX.
@@ -1686,11 +1768,11 @@ void QCborContainerPrivate::decodeValueFromCbor(QCborStreamReader &reader, int r
     case QCborStreamReader::Array:
     case QCborStreamReader::Map:
         return append(makeValue(t == QCborStreamReader::Array ? QCborValue::Array : QCborValue::Map, -1,
-                                createContainerFromCbor(reader, remainingRecursionDepth),
+                                createContainerFromCbor(reader, remainingRecursionDepth, external.data()),
                                 MoveContainer));
 
     case QCborStreamReader::Tag:
-        return append(taggedValueFromCbor(reader, remainingRecursionDepth));
+        return append(taggedValueFromCbor(reader, remainingRecursionDepth, external.data()));
 
     case QCborStreamReader::Invalid:
         return;                 // probably a decode error
@@ -1993,7 +2075,7 @@ QDateTime QCborValue::toDateTime(const QDateTime &defaultValue) const
         return defaultValue;
 
     Q_ASSERT(n == -1);
-    const ByteData *byteData = container->byteData(1);
+    const ByteDataView byteData = container->byteData(1);
     if (!byteData)
         return defaultValue; // date/times are never empty, so this must be invalid
 
@@ -2017,7 +2099,7 @@ QUrl QCborValue::toUrl(const QUrl &defaultValue) const
         return defaultValue;
 
     Q_ASSERT(n == -1);
-    const ByteData *byteData = container->byteData(1);
+    const ByteDataView byteData = container->byteData(1);
     if (!byteData)
         return QUrl();  // valid, empty URL
 
@@ -2060,7 +2142,7 @@ QUuid QCborValue::toUuid(const QUuid &defaultValue) const
         return defaultValue;
 
     Q_ASSERT(n == -1);
-    const ByteData *byteData = container->byteData(1);
+    const ByteDataView byteData = container->byteData(1);
     if (!byteData)
         return defaultValue; // UUIDs must always be 16 bytes, so this must be invalid
 
@@ -2420,6 +2502,11 @@ enum { MaximumRecursionDepth = 1024 };
     \sa toCbor(), toDiagnosticNotation(), toVariant(), toJsonValue()
  */
 QCborValue QCborValue::fromCbor(QCborStreamReader &reader)
+{
+    return QCborContainerPrivate::decodeFromCbor(reader, nullptr);
+}
+
+QCborValue QCborContainerPrivate::decodeFromCbor(QCborStreamReader &reader, QtCbor::ExternalData *external)
 {
     QCborValue result;
     auto t = reader.type();
@@ -2448,9 +2535,10 @@ QCborValue QCborValue::fromCbor(QCborStreamReader &reader)
     case QCborStreamReader::ByteArray:
     case QCborStreamReader::String:
         result.n = 0;
-        result.t = reader.isString() ? String : ByteArray;
+        result.t = reader.isString() ? QCborValue::String : QCborValue::ByteArray;
         result.container = new QCborContainerPrivate;
         result.container->ref.ref();
+        result.container->external = external;
         result.container->decodeStringFromCbor(reader);
         break;
 
@@ -2458,13 +2546,13 @@ QCborValue QCborValue::fromCbor(QCborStreamReader &reader)
     case QCborStreamReader::Array:
     case QCborStreamReader::Map:
         result.n = -1;
-        result.t = reader.isArray() ? Array : Map;
-        result.container = createContainerFromCbor(reader, MaximumRecursionDepth);
+        result.t = reader.isArray() ? QCborValue::Array : QCborValue::Map;
+        result.container = createContainerFromCbor(reader, MaximumRecursionDepth, external);
         break;
 
     // tag
     case QCborStreamReader::Tag:
-        result = taggedValueFromCbor(reader, MaximumRecursionDepth);
+        result = taggedValueFromCbor(reader, MaximumRecursionDepth, external);
         break;
     }
 
@@ -2504,6 +2592,47 @@ QCborValue QCborValue::fromCbor(const QByteArray &ba, QCborParserError *error)
     return result;
 }
 
+/*!
+    \since 6.2
+
+    Decodes one item from the CBOR file \a fileName and returns the equivalent
+    representation, like fromCbor() does for a byte array.
+
+    Unlike reading the file into a QByteArray and decoding that, this function
+    memory-maps the file and decodes it in place: the contents of byte arrays
+    and strings found in it are not copied, but referred to in the mapped file,
+    which stays mapped for as long as any value decoded from it exists. This
+    reduces both the time needed to load large files and the memory used to
+    hold them. Extracting or modifying such contents copies them.
+
+    The file must not be modified or truncated while it is mapped.
+
+    This function stores the error state, if any, in the object pointed to by
+    \a error, along with the offset of where the error occurred. If the file
+    cannot be opened, the error is \l{QCborError}{InputOutputError}.
+
+    \sa fromCbor(), QFile::map()
+ */
+QCborValue QCborValue::fromCborFile(const QString &fileName, QCborParserError *error)
+{
+    QExplicitlySharedDataPointer<QtCbor::ExternalData> external(QtCbor::mapFile(fileName));
+    if (!external) {
+        if (error) {
+            error->error = { QCborError::InputOutputError };
+            error->offset = 0;
+        }
+        return QCborValue();
+    }
+
+    QCborStreamReader reader(QByteArray::fromRawData(external->begin, external->size));
+    QCborValue result = QCborContainerPrivate::decodeFromCbor(reader, external.data());
+    if (error) {
+        error->error = reader.lastError();
+        error->offset = reader.currentOffset();
+    }
+    return result;
+}
+
 /*!
     \fn QCborValue QCborValue::fromCbor(const char *data, qsizetype len, QCborParserError *error)
     \fn QCborValue QCborValue::fromCbor(const quint8 *data, qsizetype len, QCborParserError *error)
@@ -72,7 +72,8 @@ struct Element
         IsContainer                 = 0x0001,
         HasByteData                 = 0x0002,
         StringIsUtf16               = 0x0004,
-        StringIsAscii               = 0x0008
+        StringIsAscii               = 0x0008,
+        ByteDataIsExternal          = 0x0010
     };
     Q_DECLARE_FLAGS(ValueFlags, ValueFlag)
 
@@ -121,6 +122,44 @@ struct ByteData
 };
 static_assert(std::is_trivial<ByteData>::value);
 static_assert(std::is_standard_layout<ByteData>::value);
+
+// Read-only view of an element's byte data, which is either stored inline in
+// the container's data block or lives in an ExternalData buffer (see below).
+struct ByteDataView
+{
+    const char *ptr = nullptr;
+    QByteArray::size_type len = 0;
+
+    const ByteDataView *operator->() const { return this; }
+    explicit operator bool() const  { return ptr != nullptr; }
+
+    const char *byte() const        { return ptr; }
+    const QChar *utf16() const      { return reinterpret_cast<const QChar *>(ptr); }
+
+    QByteArray toByteArray() const  { return QByteArray(byte(), len); }
+    QString toString() const        { return QString(utf16(), len / 2); }
+    QString toUtf8String() const    { return QString::fromUtf8(byte(), len); }
+
+    QByteArray asByteArrayView() const { return QByteArray::fromRawData(byte(), len); }
+    QLatin1String asLatin1() const  { return QLatin1String(byte(), len); }
+    QStringView asStringView() const{ return QStringView(utf16(), len / 2); }
+    QString asQStringRaw() const    { return QString::fromRawData(utf16(), len / 2); }
+};
+
+// Read-only memory that elements flagged ByteDataIsExternal point into, such
+// as a memory-mapped file. Containers referring to it keep it alive.
+struct ExternalData : public QSharedData
+{
+    virtual ~ExternalData() = default;
+
+    const char *begin = nullptr;
+    qsizetype size = 0;
+};
+
+// Strings shorter than this are cheaper to copy than to refer to.
+static constexpr qsizetype MinimumExternalByteDataSize = qsizetype(sizeof(const char *));
+
+ExternalData *mapFile(const QString &fileName);
 } // namespace QtCbor
 
 Q_DECLARE_TYPEINFO(QtCbor::Element, Q_PRIMITIVE_TYPE);
@@ -136,6 +175,7 @@ public:
     QByteArray::size_type usedData = 0;
     QByteArray data;
     QList<QtCbor::Element> elements;
+    QExplicitlySharedDataPointer<QtCbor::ExternalData> external;
 
     void deref() { if (!ref.deref()) delete this; }
     void compact(qsizetype reserved);
@@ -169,20 +209,38 @@ public:
         return offset;
     }
 
-    const QtCbor::ByteData *byteData(QtCbor::Element e) const
+    qptrdiff addExternalByteData(const char *block, qsizetype len)
+    {
+        // The record stores a pointer into the external buffer instead of the
+        // bytes themselves; its len is that of the string it refers to.
+        Q_ASSERT(external);
+        Q_ASSERT(block >= external->begin && block + len <= external->begin + external->size);
+        qptrdiff offset = addByteData(reinterpret_cast<const char *>(&block), sizeof(block));
+        usedData += len - qsizetype(sizeof(block));
+        reinterpret_cast<QtCbor::ByteData *>(data.data() + offset)->len = len;
+        return offset;
+    }
+
+    QtCbor::ByteDataView byteData(QtCbor::Element e) const
     {
         if ((e.flags & QtCbor::Element::HasByteData) == 0)
-            return nullptr;
+            return {};
 
         size_t offset = size_t(e.value);
         Q_ASSERT((offset % alignof(QtCbor::ByteData)) == 0);
         Q_ASSERT(offset + sizeof(QtCbor::ByteData) <= size_t(data.size()));
 
         auto b = reinterpret_cast<const QtCbor::ByteData *>(data.constData() + offset);
+        if (e.flags & QtCbor::Element::ByteDataIsExternal) {
+            const char *ptr;
+            memcpy(&ptr, b->byte(), sizeof(ptr));
+            Q_ASSERT(external && ptr + b->len <= external->begin + external->size);
+            return { ptr, b->len };
+        }
         Q_ASSERT(offset + sizeof(*b) + size_t(b->len) <= size_t(data.size()));
-        return b;
+        return { b->byte(), b->len };
     }
-    const QtCbor::ByteData *byteData(qsizetype idx) const
+    QtCbor::ByteDataView byteData(qsizetype idx) const
     {
         return byteData(elements.at(idx));
     }
@@ -240,6 +298,13 @@ public:
         elements.append(QtCbor::Element(addByteData(data, len), type,
                                         QtCbor::Element::HasByteData | extraFlags));
     }
+    void appendExternalByteData(const char *data, qsizetype len, QCborValue::Type type,
+                                QtCbor::Element::ValueFlags extraFlags = {})
+    {
+        elements.append(QtCbor::Element(addExternalByteData(data, len), type,
+                                        QtCbor::Element::HasByteData
+                                        | QtCbor::Element::ByteDataIsExternal | extraFlags));
+    }
     void appendAsciiString(const QString &s);
     void appendAsciiString(const char *str, qsizetype len)
     {
@@ -366,12 +431,12 @@ public:
         return e;
     }
 
-    static int compareUtf8(const QtCbor::ByteData *b, const QLatin1String &s)
+    static int compareUtf8(QtCbor::ByteDataView b, const QLatin1String &s)
     {
         return QUtf8::compareUtf8(QByteArrayView(b->byte(), b->len), s);
     }
 
-    static int compareUtf8(const QtCbor::ByteData *b, QStringView s)
+    static int compareUtf8(QtCbor::ByteDataView b, QStringView s)
     {
         return QUtf8::compareUtf8(QByteArrayView(b->byte(), b->len), s);
     }
@@ -382,7 +447,7 @@ public:
         if (e.type != QCborValue::String)
             return int(e.type) - int(QCborValue::String);
 
-        const QtCbor::ByteData *b = byteData(e);
+        QtCbor::ByteDataView b = byteData(e);
         if (!b)
             return s.isEmpty() ? 0 : -1;
 
@@ -421,6 +486,7 @@ public:
 #if QT_CONFIG(cborstreamreader)
     void decodeValueFromCbor(QCborStreamReader &reader, int remainingStackDepth);
     void decodeStringFromCbor(QCborStreamReader &reader);
+    static QCborValue decodeFromCbor(QCborStreamReader &reader, QtCbor::ExternalData *external);
     static inline void setErrorInReader(QCborStreamReader &reader, QCborError error);
 #endif
 };
@@ -76,7 +76,7 @@ static QString simpleTypeString(QCborValue::Type t)
 
 static QString encodeByteArray(const QCborContainerPrivate *d, qsizetype idx, QCborTag encoding)
 {
-    const ByteData *b = d->byteData(idx);
+    const ByteDataView b = d->byteData(idx);
     if (!b)
         return QString();
 
@@ -98,7 +98,7 @@ static QString maybeEncodeTag(const QCborContainerPrivate *d)
 {
     qint64 tag = d->elements.at(0).value;
     const Element &e = d->elements.at(1);
-    const ByteData *b = d->byteData(e);
+    const ByteDataView b = d->byteData(e);
 
     switch (tag) {
     case qint64(QCborKnownTags::DateTimeString):
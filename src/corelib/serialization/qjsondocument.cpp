@@ -324,6 +324,57 @@ QJsonDocument QJsonDocument::fromJson(const QByteArray &json, QJsonParseError *e
     return result;
 }
 
+/*!
+ \since 6.2
+
+ Parses the file \a fileName as a UTF-8 encoded JSON document, and creates a
+ QJsonDocument from it.
+
+ Unlike reading the file into a QByteArray and calling fromJson(), this
+ function memory-maps the file and parses it in place: strings that contain no
+ escape sequences are not copied into the document, but referred to in the
+ mapped file, which stays mapped for as long as the document or any value
+ obtained from it exists. This reduces both the time needed to load large
+ documents and the memory used to hold them. Modifying such strings copies
+ them.
+
+ The file must not be modified or truncated while it is mapped.
+
+ Returns a valid (non-null) QJsonDocument if the parsing succeeds. If it fails,
+ the returned document will be null, and the optional \a error variable will
+ contain further details about the error. If the file cannot be opened, the
+ error is QJsonParseError::FileError.
+
+ \sa fromJson(), QFile::map()
+ */
+QJsonDocument QJsonDocument::fromJsonFile(const QString &fileName, QJsonParseError *error)
+{
+    QExplicitlySharedDataPointer<QtCbor::ExternalData> external(QtCbor::mapFile(fileName));
+    if (!external) {
+        if (error) {
+            error->offset = 0;
+            error->error = QJsonParseError::FileError;
+        }
+        return QJsonDocument();
+    }
+    if (external->size > std::numeric_limits<int>::max()) {
+        if (error) {
+            error->offset = 0;
+            error->error = QJsonParseError::DocumentTooLarge;
+        }
+        return QJsonDocument();
+    }
+
+    QJsonPrivate::Parser parser(external.data());
+    QJsonDocument result;
+    const QCborValue val = parser.parse(error);
+    if (val.isArray() || val.isMap()) {
+        result.d = std::make_unique<QJsonDocumentPrivate>();
+        result.d->value = val;
+    }
+    return result;
+}
+
 /*!
     Returns \c true if the document doesn't contain any data.
  */
@@ -69,7 +69,9 @@ struct Q_CORE_EXPORT QJsonParseError
         MissingObject,
         DeepNesting,
         DocumentTooLarge,
-        GarbageAtEnd
+        GarbageAtEnd,
+        FileError,
+        PrematureEndOfDocument
     };
 
     QString    errorString() const;
@@ -115,6 +117,7 @@ public:
     };
 
     static QJsonDocument fromJson(const QByteArray &json, QJsonParseError *error = nullptr);
+    static QJsonDocument fromJsonFile(const QString &fileName, QJsonParseError *error = nullptr);
 
 #if !defined(QT_JSON_READONLY) || defined(Q_CLANG_QDOC)
     QByteArray toJson(JsonFormat format = Indented) const;
@@ -47,6 +47,7 @@
 #include "private/qstringconverter_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -80,6 +81,8 @@ QT_BEGIN_NAMESPACE
 #define JSONERR_DEEP_NEST   QT_TRANSLATE_NOOP("QJsonParseError", "too deeply nested document")
 #define JSONERR_DOC_LARGE   QT_TRANSLATE_NOOP("QJsonParseError", "too large document")
 #define JSONERR_GARBAGEEND  QT_TRANSLATE_NOOP("QJsonParseError", "garbage at the end of the document")
+#define JSONERR_FILE_ERROR  QT_TRANSLATE_NOOP("QJsonParseError", "file could not be read")
+#define JSONERR_PREMATURE   QT_TRANSLATE_NOOP("QJsonParseError", "premature end of document")
 
 /*!
     \class QJsonParseError
@@ -114,6 +117,10 @@ QT_BEGIN_NAMESPACE
     \value DeepNesting              The JSON document is too deeply nested for the parser to parse it
     \value DocumentTooLarge         The JSON document is too large for the parser to parse it
     \value GarbageAtEnd             The parsed document contains additional garbage characters at the end
+    \value FileError                The JSON file could not be opened or read (since Qt 6.2)
+    \value PrematureEndOfDocument   The input ended before the current token was complete. This
+                                    is only reported by QJsonStreamReader, which can continue
+                                    once more data is available (since Qt 6.2)
 
 */
 
@@ -189,6 +196,12 @@ QString QJsonParseError::errorString() const
     case GarbageAtEnd:
         sz = JSONERR_GARBAGEEND;
         break;
+    case FileError:
+        sz = JSONERR_FILE_ERROR;
+        break;
+    case PrematureEndOfDocument:
+        sz = JSONERR_PREMATURE;
+        break;
     }
 #ifndef QT_BOOTSTRAPPED
     return QCoreApplication::translate("QJsonParseError", sz);
@@ -230,6 +243,25 @@ Parser::Parser(const char *json, int length)
     end = json + length;
 }
 
+/*!
+    \internal
+
+    Creates a parser for the contents of \a external. Strings without escape
+    sequences are not copied into the parsed containers, but referred to in
+    \a external, which the containers keep alive.
+*/
+Parser::Parser(QtCbor::ExternalData *external)
+    : Parser(external->begin, int(external->size))
+{
+    this->external = external;
+}
+
+inline void Parser::createContainer()
+{
+    container = new QCborContainerPrivate;
+    container->external = external;
+}
+
 
 
 /*
@@ -272,6 +304,102 @@ enum {
     Quote = 0x22
 };
 
+/*
+    Returns a pointer to the first character in [json, end) that is not JSON
+    whitespace, or \a end if there is none. Indented documents have long runs
+    of whitespace, so they are skipped 16 bytes at a time.
+*/
+static const char *skipWhitespace(const char *json, const char *end)
+{
+#if defined(__SSE2__)
+    const __m128i spaces = _mm_set1_epi8(Space);
+    const __m128i tabs = _mm_set1_epi8(Tab);
+    const __m128i lineFeeds = _mm_set1_epi8(LineFeed);
+    const __m128i returns = _mm_set1_epi8(Return);
+    while (json + 16 <= end) {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, spaces),
+                                               _mm_cmpeq_epi8(data, tabs)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(data, lineFeeds),
+                                               _mm_cmpeq_epi8(data, returns)));
+        uint mask = ~uint(_mm_movemask_epi8(ws)) & 0xffff;
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+        json += 16;
+    }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    while (json + 16 <= end) {
+        uint8x16_t data = vld1q_u8(reinterpret_cast<const uint8_t *>(json));
+        uint8x16_t ws = vorrq_u8(vorrq_u8(vceqq_u8(data, vdupq_n_u8(Space)),
+                                          vceqq_u8(data, vdupq_n_u8(Tab))),
+                                 vorrq_u8(vceqq_u8(data, vdupq_n_u8(LineFeed)),
+                                          vceqq_u8(data, vdupq_n_u8(Return))));
+        if (vminvq_u8(ws) == 0)
+            break;      // the scalar loop below finds it
+        json += 16;
+    }
+#endif
+    while (json < end) {
+        if (*json != Space && *json != Tab && *json != LineFeed && *json != Return)
+            break;
+        ++json;
+    }
+    return json;
+}
+
+/*
+    Returns a pointer to the first character in [json, end) that ends a run of
+    plain US-ASCII string contents: a quote, a backslash or the first byte of a
+    multi-byte UTF-8 sequence. Returns \a end if there is none. This is the
+    hot loop when parsing strings, so it tests 16 (or 32) bytes at a time.
+*/
+static const char *scanAsciiStringContents(const char *json, const char *end)
+{
+#if defined(__SSE2__)
+    const __m128i quotes = _mm_set1_epi8(Quote);
+    const __m128i backslashes = _mm_set1_epi8('\\');
+#  if defined(__AVX2__)
+    const __m256i quotes256 = _mm256_broadcastsi128_si256(quotes);
+    const __m256i backslashes256 = _mm256_broadcastsi128_si256(backslashes);
+    while (json + 32 <= end) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json));
+        __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(data, quotes256),
+                                          _mm256_cmpeq_epi8(data, backslashes256));
+        // the high bit of the data itself flags the non-ASCII bytes
+        uint mask = uint(_mm256_movemask_epi8(_mm256_or_si256(special, data)));
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+        json += 32;
+    }
+#  endif
+    while (json + 16 <= end) {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(data, quotes),
+                                       _mm_cmpeq_epi8(data, backslashes));
+        uint mask = uint(_mm_movemask_epi8(_mm_or_si128(special, data)));
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+        json += 16;
+    }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    while (json + 16 <= end) {
+        uint8x16_t data = vld1q_u8(reinterpret_cast<const uint8_t *>(json));
+        uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(data, vdupq_n_u8(Quote)),
+                                               vceqq_u8(data, vdupq_n_u8('\\'))),
+                                      vcgeq_u8(data, vdupq_n_u8(0x80)));
+        if (vmaxvq_u8(special))
+            break;      // the scalar loop below finds it
+        json += 16;
+    }
+#endif
+    while (json < end) {
+        if (*json == Quote || *json == '\\' || uchar(*json) >= 0x80)
+            break;
+        ++json;
+    }
+    return json;
+}
+
 void Parser::eatBOM()
 {
     // eat UTF-8 byte order mark
@@ -285,16 +413,10 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
-            break;
-        ++json;
-    }
+    // most tokens are not preceded by whitespace at all, or by a single space
+    if (json < end && *json > Space)
+        return true;
+    json = skipWhitespace(json, end);
     return (json < end);
 }
 
@@ -335,13 +457,13 @@ QCborValue Parser::parse(QJsonParseError *error)
 
     DEBUG << Qt::hex << (uint)token;
     if (token == BeginArray) {
-        container = new QCborContainerPrivate;
+        createContainer();
         if (!parseArray())
             goto error;
         data = QCborContainerPrivate::makeValue(QCborValue::Array, -1, container.take(),
                                                 QCborContainerPrivate::MoveContainer);
     } else if (token == BeginObject) {
-        container = new QCborContainerPrivate;
+        createContainer();
         if (!parseObject())
             goto error;
         data = QCborContainerPrivate::makeValue(QCborValue::Map, -1, container.take(),
@@ -393,8 +515,8 @@ static void sortContainer(QCborContainerPrivate *container)
         Q_ASSERT(aKey.flags & QtCbor::Element::HasByteData);
         Q_ASSERT(bKey.flags & QtCbor::Element::HasByteData);
 
-        const QtCbor::ByteData *aData = container->byteData(aKey);
-        const QtCbor::ByteData *bData = container->byteData(bKey);
+        const QtCbor::ByteDataView aData = container->byteData(aKey);
+        const QtCbor::ByteDataView bData = container->byteData(bKey);
 
         if (!aData)
             return bData ? -1 : 0;
@@ -451,7 +573,7 @@ bool Parser::parseObject()
     char token = nextToken();
     while (token == Quote) {
         if (!container)
-            container = new QCborContainerPrivate;
+            createContainer();
         if (!parseMember())
             return false;
         token = nextToken();
@@ -529,7 +651,7 @@ bool Parser::parseArray()
                 return false;
             }
             if (!container)
-                container = new QCborContainerPrivate;
+                createContainer();
             if (!parseValue())
                 return false;
             char token = nextToken();
@@ -676,18 +798,23 @@ bool Parser::parseNumber()
 
     const char *start = json;
     bool isInt = true;
+    bool isNegative = false;
 
     // minus
-    if (json < end && *json == '-')
+    if (json < end && *json == '-') {
+        isNegative = true;
         ++json;
+    }
 
     // int = zero / ( digit1-9 *DIGIT )
+    const char *digits = json;
     if (json < end && *json == '0') {
         ++json;
     } else {
         while (json < end && *json >= '0' && *json <= '9')
             ++json;
     }
+    const char *digitsEnd = json;
 
     // frac = decimal-point 1*DIGIT
     if (json < end && *json == '.') {
@@ -713,6 +840,17 @@ bool Parser::parseNumber()
         return false;
     }
 
+    // Plain integers that can't overflow (up to 18 digits) are the common
+    // case and need no conversion through QByteArray.
+    if (json == digitsEnd && digitsEnd > digits && digitsEnd - digits <= 18) {
+        qint64 n = 0;
+        for (const char *p = digits; p != digitsEnd; ++p)
+            n = n * 10 + (*p - '0');
+        container->append(isNegative ? -n : n);
+        END;
+        return true;
+    }
+
     const QByteArray number = QByteArray::fromRawData(start, json - start);
     DEBUG << "numberstring" << number;
 
@@ -848,6 +986,10 @@ bool Parser::parseString()
     bool isUtf8 = true;
     bool isAscii = true;
     while (json < end) {
+        json = scanAsciiStringContents(json, end);
+        if (json == end)
+            break;
+
         uint ch = 0;
         if (*json == '"')
             break;
@@ -865,7 +1007,6 @@ bool Parser::parseString()
         }
         if (ch > 0x7f)
             isAscii = false;
-        DEBUG << "  " << ch << char(ch);
     }
     ++json;
     DEBUG << "end of string";
@@ -876,6 +1017,14 @@ bool Parser::parseString()
 
     // no escape sequences, we are done
     if (isUtf8) {
+        const qsizetype len = json - start - 1;
+        if (external && len >= QtCbor::MinimumExternalByteDataSize) {
+            container->appendExternalByteData(start, len, QCborValue::String,
+                                              isAscii ? QtCbor::Element::StringIsAscii
+                                                      : QtCbor::Element::ValueFlags());
+            END;
+            return true;
+        }
         if (isAscii)
             container->appendAsciiString(start, json - start - 1);
         else
@@ -890,6 +1039,14 @@ bool Parser::parseString()
 
     QString ucs4;
     while (json < end) {
+        // append runs of plain US-ASCII in one go
+        const char *run = json;
+        json = scanAsciiStringContents(json, end);
+        if (json != run)
+            ucs4.append(QLatin1String(run, json - run));
+        if (json == end)
+            break;
+
         uint ch = 0;
         if (*json == '"')
             break;
@@ -919,4 +1076,43 @@ bool Parser::parseString()
     return true;
 }
 
+/*!
+    \internal
+
+    Decodes the contents of a string token, the characters between its
+    quotes in [\a json, \a end), into \a result.
+*/
+QJsonParseError::ParseError QJsonPrivate::decodeString(const char *json, const char *end,
+                                                       QString *result)
+{
+    const char *run = json;
+    json = scanAsciiStringContents(json, end);
+    if (json == end) {
+        *result = QString::fromLatin1(run, json - run);
+        return QJsonParseError::NoError;
+    }
+
+    result->clear();
+    result->reserve(end - run);
+    while (true) {
+        if (json != run)
+            result->append(QLatin1String(run, json - run));
+        if (json == end)
+            break;
+
+        uint ch = 0;
+        if (*json == '\\') {
+            if (!scanEscapeSequence(json, end, &ch))
+                return QJsonParseError::IllegalEscapeSequence;
+        } else if (!scanUtf8Char(json, end, &ch)) {
+            return QJsonParseError::IllegalUTF8String;
+        }
+        result->append(QChar::fromUcs4(ch));
+
+        run = json;
+        json = scanAsciiStringContents(json, end);
+    }
+    return QJsonParseError::NoError;
+}
+
 QT_END_NAMESPACE
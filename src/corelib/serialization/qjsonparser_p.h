@@ -63,6 +63,7 @@ class Parser
 {
 public:
     Parser(const char *json, int length);
+    Parser(QtCbor::ExternalData *external);
 
     QCborValue parse(QJsonParseError *error);
 
@@ -77,6 +78,8 @@ private:
     bool parseString();
     bool parseValue();
     bool parseNumber();
+    inline void createContainer();
+
     const char *head;
     const char *json;
     const char *end;
@@ -84,8 +87,11 @@ private:
     int nestingLevel;
     QJsonParseError::ParseError lastError;
     QExplicitlySharedDataPointer<QCborContainerPrivate> container;
+    QExplicitlySharedDataPointer<QtCbor::ExternalData> external;
 };
 
+QJsonParseError::ParseError decodeString(const char *json, const char *end, QString *result);
+
 }
 
 QT_END_NAMESPACE
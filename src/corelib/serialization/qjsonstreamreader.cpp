@@ -0,0 +1,968 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonstreamreader.h"
+
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+
+#include <private/qjson_p.h>
+#include <private/qjsonparser_p.h>
+#include <private/qnumeric_p.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+static const int nestingLimit = 1024;
+static const qint64 ReadChunkSize = 64 * 1024;
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum State : quint8 {
+        ExpectValue,                // at top level, after a colon or a comma in an array
+        ExpectValueOrEndArray,      // right after '['
+        ExpectNameOrEndObject,      // right after '{'
+        ExpectName,                 // after a comma in an object
+        ExpectColon,                // after a name
+        ExpectCommaOrEnd            // after a value inside a container
+    };
+
+    // returned by tryReadNext() when the buffer ends in the middle of a token
+    enum { NeedMoreData = -1 };
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    qsizetype pos = 0;              // next byte to tokenize
+    qsizetype tokenStart = 0;       // first byte of the current token
+    qsizetype scanned = 0;          // bytes after pos known not to end a pending string
+    qint64 discarded = 0;           // bytes dropped from the front of the buffer
+
+    QVarLengthArray<char, 16> containers;   // '[' or '{' for each open container
+    State state = ExpectValue;
+    QJsonStreamReader::TokenType token = QJsonStreamReader::NoToken;
+    QJsonParseError::ParseError lastError = QJsonParseError::NoError;
+    bool atEnd = false;
+    bool endOfInput = false;        // no data will be added or arrive on the device
+    bool needSeparator = false;     // a top-level value ended, whitespace must follow
+
+    QString text;
+    double number = 0;
+    qint64 integer = 0;
+    bool isInteger = false;
+    bool boolean = false;
+
+    bool hasFatalError() const
+    {
+        return lastError != QJsonParseError::NoError
+                && lastError != QJsonParseError::PrematureEndOfDocument;
+    }
+
+    int setError(QJsonParseError::ParseError error)
+    {
+        lastError = error;
+        return QJsonStreamReader::Invalid;
+    }
+
+    int finishValue(QJsonStreamReader::TokenType type)
+    {
+        scanned = 0;
+        state = containers.isEmpty() ? ExpectValue : ExpectCommaOrEnd;
+        needSeparator = containers.isEmpty();
+        return type;
+    }
+
+    bool isFinalData() const
+    {
+        // without a device or with a sequential one, only the user knows
+        // whether more data will come
+        if (!device)
+            return endOfInput;
+        if (!device->isOpen())
+            return true;
+        return (endOfInput || !device->isSequential()) && device->atEnd();
+    }
+
+    void reset();
+    bool fillBuffer();
+    int tryReadNext();
+    int parseValue(char c);
+    int parseEnd(char c);
+    int parseString(QString *result);
+    int parseNumber();
+    int parseLiteral(const char *literal, qsizetype len, QJsonStreamReader::TokenType type);
+};
+
+void QJsonStreamReaderPrivate::reset()
+{
+    buffer.clear();
+    pos = tokenStart = scanned = 0;
+    discarded = 0;
+    containers.clear();
+    state = ExpectValue;
+    token = QJsonStreamReader::NoToken;
+    lastError = QJsonParseError::NoError;
+    atEnd = false;
+    endOfInput = false;
+    needSeparator = false;
+    text.clear();
+}
+
+/*
+    Reads the next chunk of data from the device into the buffer. Data before
+    the start of the current token is dropped first, so the buffer only grows
+    beyond the chunk size when a single token (or a value consumed by
+    readValue()) is larger than that.
+*/
+bool QJsonStreamReaderPrivate::fillBuffer()
+{
+    if (!device)
+        return false;
+
+    if (tokenStart > 0 && tokenStart >= buffer.size() / 2) {
+        buffer.remove(0, tokenStart);
+        discarded += tokenStart;
+        pos -= tokenStart;
+        tokenStart = 0;
+    }
+
+    const qsizetype oldSize = buffer.size();
+    buffer.resize(oldSize + ReadChunkSize);
+    const qint64 n = device->read(buffer.data() + oldSize, ReadChunkSize);
+    buffer.resize(oldSize + qMax(n, qint64(0)));
+    return n > 0;
+}
+
+static inline bool isJsonWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline bool isAsciiDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+int QJsonStreamReaderPrivate::tryReadNext()
+{
+    const qsizetype size = buffer.size();
+    const char *data = buffer.constData();
+
+    if (discarded == 0 && pos == 0 && size > 0 && uchar(data[0]) == 0xef) {
+        // skip a UTF-8 byte order mark
+        static const char bom[] = "\xef\xbb\xbf";
+        if (memcmp(data, bom, qMin(size, qsizetype(3))) == 0) {
+            if (size < 3)
+                return NeedMoreData;
+            pos = 3;
+        }
+    }
+
+    for (;;) {
+        if (pos < size && isJsonWhitespace(data[pos])) {
+            needSeparator = false;
+            do {
+                ++pos;
+            } while (pos < size && isJsonWhitespace(data[pos]));
+        }
+        tokenStart = pos;
+        if (pos == size)
+            return NeedMoreData;
+
+        const char c = data[pos];
+        switch (state) {
+        case ExpectValue:
+            // top-level values must be separated by whitespace
+            if (needSeparator)
+                return setError(QJsonParseError::GarbageAtEnd);
+            return parseValue(c);
+
+        case ExpectValueOrEndArray:
+            if (c == ']')
+                return parseEnd(c);
+            return parseValue(c);
+
+        case ExpectNameOrEndObject:
+            if (c == '}')
+                return parseEnd(c);
+            if (c != '"')
+                return setError(QJsonParseError::UnterminatedObject);
+            break;
+
+        case ExpectName:
+            if (c == '}')
+                return setError(QJsonParseError::MissingObject);
+            if (c != '"')
+                return setError(QJsonParseError::UnterminatedObject);
+            break;
+
+        case ExpectColon:
+            if (c != ':')
+                return setError(QJsonParseError::MissingNameSeparator);
+            ++pos;
+            state = ExpectValue;
+            continue;
+
+        case ExpectCommaOrEnd:
+            if (c == ',') {
+                ++pos;
+                state = containers.last() == '[' ? ExpectValue : ExpectName;
+                continue;
+            }
+            return parseEnd(c);
+        }
+
+        // a member name
+        const int result = parseString(&text);
+        if (result != QJsonStreamReader::String)
+            return result;
+        state = ExpectColon;
+        return QJsonStreamReader::Name;
+    }
+}
+
+int QJsonStreamReaderPrivate::parseValue(char c)
+{
+    switch (c) {
+    case '[':
+    case '{':
+        if (containers.size() >= nestingLimit)
+            return setError(QJsonParseError::DeepNesting);
+        containers.append(c);
+        ++pos;
+        if (c == '[') {
+            state = ExpectValueOrEndArray;
+            return QJsonStreamReader::StartArray;
+        }
+        state = ExpectNameOrEndObject;
+        return QJsonStreamReader::StartObject;
+
+    case '"': {
+        const int result = parseString(&text);
+        if (result != QJsonStreamReader::String)
+            return result;
+        return finishValue(QJsonStreamReader::String);
+    }
+
+    case 't':
+        boolean = true;
+        return parseLiteral("true", 4, QJsonStreamReader::Bool);
+    case 'f':
+        boolean = false;
+        return parseLiteral("false", 5, QJsonStreamReader::Bool);
+    case 'n':
+        return parseLiteral("null", 4, QJsonStreamReader::Null);
+
+    default:
+        if (c == '-' || isAsciiDigit(c))
+            return parseNumber();
+        break;
+    }
+
+    // a closing bracket here means a value was expected after a comma
+    if (!containers.isEmpty() && (c == ']' || c == '}'))
+        return setError(QJsonParseError::MissingObject);
+    return setError(QJsonParseError::IllegalValue);
+}
+
+int QJsonStreamReaderPrivate::parseEnd(char c)
+{
+    const char open = containers.isEmpty() ? 0 : containers.last();
+    if ((open == '[' && c != ']') || (open == '{' && c != '}')) {
+        return setError(open == '[' ? QJsonParseError::MissingValueSeparator
+                                    : QJsonParseError::UnterminatedObject);
+    }
+
+    containers.removeLast();
+    ++pos;
+    return finishValue(c == ']' ? QJsonStreamReader::EndArray : QJsonStreamReader::EndObject);
+}
+
+/*
+    Decodes the string starting at the opening quote at pos. Returns
+    QJsonStreamReader::String on success. If the closing quote is not in the
+    buffer yet, pos is left untouched and the part already searched is
+    remembered in scanned, so that resuming after more data has arrived does
+    not search the same bytes again.
+*/
+int QJsonStreamReaderPrivate::parseString(QString *result)
+{
+    const char *begin = buffer.constData() + pos + 1;
+    const char *end = buffer.constData() + buffer.size();
+    const char *p = begin + qMax(scanned - 1, qsizetype(0));
+
+    for (;;) {
+        const char *quote = static_cast<const char *>(memchr(p, '"', end - p));
+        if (!quote) {
+            scanned = end - begin;
+            return NeedMoreData;
+        }
+
+        // the quote is escaped if it is preceded by an odd number of backslashes
+        const char *b = quote;
+        while (b > begin && b[-1] == '\\')
+            --b;
+        if ((quote - b) % 2 == 0) {
+            scanned = 0;
+            const QJsonParseError::ParseError error = QJsonPrivate::decodeString(begin, quote, result);
+            if (error != QJsonParseError::NoError)
+                return setError(error);
+            pos = quote + 1 - buffer.constData();
+            return QJsonStreamReader::String;
+        }
+        p = quote + 1;
+    }
+}
+
+/*
+    number          = [ minus ] int [ frac ] [ exp ]
+    int             = zero / ( digit1-9 *DIGIT )
+    frac            = decimal-point 1*DIGIT
+    exp             = e [ minus / plus ] 1*DIGIT
+*/
+int QJsonStreamReaderPrivate::parseNumber()
+{
+    const char *start = buffer.constData() + pos;
+    const char *end = buffer.constData() + buffer.size();
+
+    const char *e = start;
+    while (e < end && (isAsciiDigit(*e) || *e == '-' || *e == '+' || *e == '.'
+                       || *e == 'e' || *e == 'E'))
+        ++e;
+
+    // outside of a container, nothing but the end of the data terminates a
+    // number, so we can only be sure we have all of it if no more will come
+    if (e == end && !(containers.isEmpty() && isFinalData()))
+        return NeedMoreData;
+
+    const char *p = start;
+    bool isInt = true;
+    if (*p == '-')
+        ++p;
+    if (p < e && *p == '0') {
+        ++p;
+    } else if (p < e && isAsciiDigit(*p)) {
+        while (p < e && isAsciiDigit(*p))
+            ++p;
+    } else {
+        return setError(QJsonParseError::IllegalNumber);
+    }
+    if (p < e && *p == '.') {
+        isInt = false;
+        ++p;
+        if (p == e || !isAsciiDigit(*p))
+            return setError(QJsonParseError::IllegalNumber);
+        while (p < e && isAsciiDigit(*p))
+            ++p;
+    }
+    if (p < e && (*p == 'e' || *p == 'E')) {
+        isInt = false;
+        ++p;
+        if (p < e && (*p == '-' || *p == '+'))
+            ++p;
+        if (p == e || !isAsciiDigit(*p))
+            return setError(QJsonParseError::IllegalNumber);
+        while (p < e && isAsciiDigit(*p))
+            ++p;
+    }
+    if (p != e)
+        return setError(QJsonParseError::IllegalNumber);
+
+    const QByteArray literal = QByteArray::fromRawData(start, e - start);
+    bool ok = false;
+    isInteger = false;
+    if (isInt) {
+        integer = literal.toLongLong(&ok);
+        if (ok) {
+            isInteger = true;
+            number = double(integer);
+        }
+    }
+    if (!isInteger) {
+        number = literal.toDouble(&ok);
+        if (!ok)
+            return setError(QJsonParseError::IllegalNumber);
+        if (qt_is_inf(number))
+            return setError(QJsonParseError::IllegalNumber);
+    }
+
+    pos = e - buffer.constData();
+    return finishValue(QJsonStreamReader::Number);
+}
+
+int QJsonStreamReaderPrivate::parseLiteral(const char *literal, qsizetype len,
+                                           QJsonStreamReader::TokenType type)
+{
+    const qsizetype available = buffer.size() - pos;
+    if (memcmp(buffer.constData() + pos, literal, qMin(available, len)) != 0)
+        return setError(QJsonParseError::IllegalValue);
+    if (available < len)
+        return NeedMoreData;
+    pos += len;
+    return finishValue(type);
+}
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.2
+
+    \brief The QJsonStreamReader class is a fast, forward-only reader for JSON
+    text.
+
+    QJsonStreamReader reads JSON one token at a time, without building a
+    QJsonDocument for the whole input. This keeps the memory use bounded by the
+    size of the largest token, no matter how large the document is, and lets
+    an application start processing a document before all of it has been
+    received.
+
+    The data is either supplied incrementally with addData() or read on demand
+    from a QIODevice set with setDevice(). Each call to readNext() returns the
+    next token. Scalar tokens carry their value, which is available from
+    text(), toDouble(), toInteger(), toBool() or value(). The reader can also
+    be asked to return a whole array or object at once with readValue().
+
+    \snippet code/src_corelib_serialization_qjsonstream.cpp 0
+
+    The reader accepts any number of JSON values one after the other at the top
+    level, separated by whitespace, so that streams of newline-delimited JSON
+    records can be read with a single reader. Values of any type are allowed at
+    the top level.
+
+    \section1 Incomplete input
+
+    When the data ends in the middle of a token, or in the middle of the
+    container being read by readValue(), the reader does not consume the
+    partial token. readNext() returns \l Invalid and error() returns
+    QJsonParseError::PrematureEndOfDocument. This error is not fatal: once more
+    data has been supplied with addData(), or has arrived on the device, the
+    next call to readNext() resumes where the reader stopped. Any other error
+    is fatal and makes all further calls to readNext() return \l Invalid.
+
+    When the data ends between two top-level values, readNext() returns
+    \l NoToken and atEnd() returns \c true.
+
+    Nothing but the end of the data terminates a number at the top level, so
+    the reader needs to know that no more data will follow before it can
+    return such a number. Data passed to the constructor, and a random-access
+    device that is at its end or a device that is closed, are known to be
+    complete. Otherwise, call setEndOfInput() once all data has been added
+    with addData(), or once a sequential device such as a socket or a process
+    will not receive any more.
+
+    \sa QJsonStreamWriter, QJsonDocument, QCborStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum describes the token the reader is positioned on.
+
+    \value NoToken      The reader has not read anything yet, or has reached
+                        the end of the data between two top-level values.
+    \value Invalid      An error occurred; see error().
+    \value StartArray   The start of an array.
+    \value EndArray     The end of an array.
+    \value StartObject  The start of an object.
+    \value EndObject    The end of an object.
+    \value Name         The name of an object member; see text().
+    \value String       A string value; see text().
+    \value Number       A number; see toDouble() and toInteger().
+    \value Bool         A boolean value; see toBool().
+    \value Null         The \c null value.
+*/
+
+/*!
+    Constructs a QJsonStreamReader with no data. Use addData() or setDevice()
+    to supply the data to read.
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Constructs a QJsonStreamReader that reads from \a data. The data is taken
+    to be complete; more data can still be appended with addData().
+
+    \sa setEndOfInput()
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : QJsonStreamReader()
+{
+    d->buffer = data;
+    d->endOfInput = true;
+}
+
+/*!
+    Constructs a QJsonStreamReader that reads from \a device. The device must
+    already be open.
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : QJsonStreamReader()
+{
+    d->device = device;
+}
+
+/*!
+    Destroys the reader. The device, if any, is not closed.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the device to read from to \a device and resets the reader. Passing
+    \nullptr makes the reader read from data added with addData() instead.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    d->reset();
+    d->device = device;
+}
+
+/*!
+    Returns the device the reader reads from, or \nullptr if there is none.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    return d->device;
+}
+
+/*!
+    Appends \a data to the data to be read. This must not be used while the
+    reader reads from a device. More data may follow, until setEndOfInput() is
+    called.
+
+    \sa readNext()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    addData(data.constData(), data.size());
+}
+
+/*!
+    \overload
+
+    Appends the \a len bytes starting at \a data to the data to be read.
+*/
+void QJsonStreamReader::addData(const char *data, qsizetype len)
+{
+    Q_ASSERT_X(!d->device, "QJsonStreamReader::addData",
+               "Cannot add data to a reader that reads from a device");
+    if (d->tokenStart > 0 && d->tokenStart >= d->buffer.size() / 2) {
+        d->buffer.remove(0, d->tokenStart);
+        d->discarded += d->tokenStart;
+        d->pos -= d->tokenStart;
+        d->tokenStart = 0;
+    }
+    d->buffer.append(data, len);
+    d->endOfInput = false;
+}
+
+/*!
+    Tells the reader that all data has been supplied: nothing more will be
+    added with addData(), and nothing beyond what is already available will
+    arrive on the sequential device the reader reads from. A number at the top
+    level is then terminated by the end of the data.
+
+    Adding data with addData() afterwards means that more data may follow
+    again.
+
+    \sa addData(), readNext()
+*/
+void QJsonStreamReader::setEndOfInput()
+{
+    d->endOfInput = true;
+}
+
+/*!
+    Removes all data and resets the reader to its initial state. The device, if
+    any, is unset.
+*/
+void QJsonStreamReader::clear()
+{
+    d->reset();
+    d->device = nullptr;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    If the data ends in the middle of a token, this function returns
+    \l Invalid and error() returns QJsonParseError::PrematureEndOfDocument;
+    calling it again after more data is available continues with the same
+    token. If the data ends between two top-level values, this function
+    returns \l NoToken.
+
+    \sa tokenType(), atEnd(), readValue()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    if (d->hasFatalError())
+        return Invalid;
+
+    d->lastError = QJsonParseError::NoError;
+    for (;;) {
+        const int result = d->tryReadNext();
+        if (result != QJsonStreamReaderPrivate::NeedMoreData) {
+            d->token = TokenType(result);
+            d->atEnd = d->token == Invalid;
+            return d->token;
+        }
+        if (!d->fillBuffer())
+            break;
+    }
+
+    // ran out of data
+    if (d->state == QJsonStreamReaderPrivate::ExpectValue && d->containers.isEmpty()
+            && d->pos == d->buffer.size()) {
+        d->token = NoToken;
+        d->atEnd = true;
+        return NoToken;
+    }
+    d->lastError = QJsonParseError::PrematureEndOfDocument;
+    d->token = Invalid;
+    d->atEnd = false;
+    return Invalid;
+}
+
+/*!
+    Returns the type of the current token.
+
+    \sa readNext()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    return d->token;
+}
+
+/*!
+    Returns \c true if the reader has read all data that was available at the
+    end of a top-level value, or if a fatal error occurred. For a reader that
+    is supplied with addData() or reads from a sequential device, more data may
+    still arrive later; readNext() then continues with it.
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    return d->atEnd;
+}
+
+/*!
+    \fn bool QJsonStreamReader::isStartArray() const
+
+    Returns \c true if the current token is \l StartArray.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndArray() const
+
+    Returns \c true if the current token is \l EndArray.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isStartObject() const
+
+    Returns \c true if the current token is \l StartObject.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndObject() const
+
+    Returns \c true if the current token is \l EndObject.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isName() const
+
+    Returns \c true if the current token is a member \l Name.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isString() const
+
+    Returns \c true if the current token is a \l String.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isNumber() const
+
+    Returns \c true if the current token is a \l Number.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isBool() const
+
+    Returns \c true if the current token is a \l Bool.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isNull() const
+
+    Returns \c true if the current token is \l Null.
+*/
+
+/*!
+    Returns the decoded text of the current token if it is a \l Name or a
+    \l String, and a null string otherwise.
+*/
+QString QJsonStreamReader::text() const
+{
+    if (d->token == Name || d->token == String)
+        return d->text;
+    return QString();
+}
+
+/*!
+    Returns \c true if the current token is a \l Number written without a
+    fraction or exponent that fits in a qint64.
+
+    \sa toInteger()
+*/
+bool QJsonStreamReader::isInteger() const
+{
+    return d->token == Number && d->isInteger;
+}
+
+/*!
+    Returns the value of the current \l Number token as a qint64. If the
+    number is not an integer, it is converted if that can be done without loss
+    of precision. Returns 0 otherwise.
+
+    \sa isInteger(), toDouble()
+*/
+qint64 QJsonStreamReader::toInteger() const
+{
+    if (d->token != Number)
+        return 0;
+    if (d->isInteger)
+        return d->integer;
+    qint64 n;
+    return convertDoubleTo(d->number, &n) ? n : 0;
+}
+
+/*!
+    Returns the value of the current \l Number token, or 0 if the current
+    token is not a number.
+
+    \sa toInteger()
+*/
+double QJsonStreamReader::toDouble() const
+{
+    return d->token == Number ? d->number : 0;
+}
+
+/*!
+    Returns the value of the current \l Bool token, or \c false if the current
+    token is not a boolean.
+*/
+bool QJsonStreamReader::toBool() const
+{
+    return d->token == Bool && d->boolean;
+}
+
+/*!
+    Returns the value of the current token if it is a scalar (\l String,
+    \l Number, \l Bool or \l Null), and an undefined QJsonValue otherwise.
+
+    \sa readValue()
+*/
+QJsonValue QJsonStreamReader::value() const
+{
+    switch (d->token) {
+    case String:
+        return QJsonValue(d->text);
+    case Number:
+        return d->isInteger ? QJsonValue(d->integer) : QJsonValue(d->number);
+    case Bool:
+        return QJsonValue(d->boolean);
+    case Null:
+        return QJsonValue(QJsonValue::Null);
+    default:
+        break;
+    }
+    return QJsonValue(QJsonValue::Undefined);
+}
+
+/*!
+    Reads the value starting at the current token and returns it.
+
+    If the current token is \l StartArray or \l StartObject, the whole
+    container is read and returned as a QJsonValue holding a QJsonArray or a
+    QJsonObject, and the reader is left on the matching \l EndArray or
+    \l EndObject token. If the current token is a scalar, this is the same as
+    value(). For any other token, an undefined QJsonValue is returned.
+
+    If the data ends before the end of the container, this function returns
+    an undefined QJsonValue, sets the error to
+    QJsonParseError::PrematureEndOfDocument and consumes nothing; call it again
+    once more data is available.
+
+    \sa readNext(), value()
+*/
+QJsonValue QJsonStreamReader::readValue()
+{
+    if (d->token != StartArray && d->token != StartObject)
+        return value();
+    if (d->hasFatalError())
+        return QJsonValue(QJsonValue::Undefined);
+
+    // Find the end of the container. Offsets are relative to the start of the
+    // token because refilling the buffer may discard the data before it.
+    d->lastError = QJsonParseError::NoError;
+    qsizetype offset = 1;
+    int level = 1;
+    bool inString = false;
+    bool escaped = false;           // the previous byte was a backslash in a string
+    for (;;) {
+        const char *data = d->buffer.constData() + d->tokenStart;
+        const qsizetype size = d->buffer.size() - d->tokenStart;
+        for ( ; offset < size; ++offset) {
+            const char c = data[offset];
+            if (escaped) {
+                escaped = false;
+            } else if (inString) {
+                if (c == '\\')
+                    escaped = true;
+                else if (c == '"')
+                    inString = false;
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '[' || c == '{') {
+                ++level;
+            } else if (c == ']' || c == '}') {
+                if (--level == 0)
+                    break;
+            }
+        }
+        if (level == 0)
+            break;
+        if (!d->fillBuffer()) {
+            d->lastError = QJsonParseError::PrematureEndOfDocument;
+            return QJsonValue(QJsonValue::Undefined);
+        }
+    }
+
+    const qsizetype length = offset + 1;
+    if (length > std::numeric_limits<int>::max()) {
+        d->lastError = QJsonParseError::DocumentTooLarge;
+        d->token = Invalid;
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    QJsonParseError parseError;
+    QJsonPrivate::Parser parser(d->buffer.constData() + d->tokenStart, int(length));
+    const QCborValue result = parser.parse(&parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        d->lastError = parseError.error;
+        d->pos = d->tokenStart + parseError.offset;
+        d->token = Invalid;
+        d->atEnd = true;
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    const char close = d->buffer.at(d->tokenStart + offset);
+    d->tokenStart += offset;
+    d->pos = d->tokenStart + 1;
+    d->containers.removeLast();
+    d->token = TokenType(d->finishValue(close == ']' ? EndArray : EndObject));
+    return QJsonPrivate::Value::fromTrustedCbor(result);
+}
+
+/*!
+    Returns the number of arrays and objects the reader is currently inside.
+*/
+int QJsonStreamReader::depth() const
+{
+    return d->containers.size();
+}
+
+/*!
+    Returns the offset from the start of the data of the next byte the reader
+    will read. After an error, this is the offset at which the error was
+    detected.
+*/
+qint64 QJsonStreamReader::currentOffset() const
+{
+    return d->discarded + d->pos;
+}
+
+/*!
+    Returns \c true if the last operation failed, including if it failed
+    because the data was incomplete.
+
+    \sa error(), errorString()
+*/
+bool QJsonStreamReader::hasError() const
+{
+    return d->lastError != QJsonParseError::NoError;
+}
+
+/*!
+    Returns the error of the last operation, or QJsonParseError::NoError if
+    there was none.
+
+    \sa hasError(), errorString()
+*/
+QJsonParseError::ParseError QJsonStreamReader::error() const
+{
+    return d->lastError;
+}
+
+/*!
+    Returns a human-readable description of error().
+*/
+QString QJsonStreamReader::errorString() const
+{
+    QJsonParseError error;
+    error.error = d->lastError;
+    error.offset = int(currentOffset());
+    return error.errorString();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qjsonstreamreader.cpp"
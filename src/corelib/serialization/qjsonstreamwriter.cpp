@@ -0,0 +1,368 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonstreamwriter.h"
+
+#include <qcborvalue.h>
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+
+#include <private/qjsonwriter_p.h>
+
+QT_BEGIN_NAMESPACE
+
+static const qsizetype FlushThreshold = 16 * 1024;
+
+class QJsonStreamWriterPrivate
+{
+public:
+    struct Container {
+        char type;              // '[' or '{'
+        bool hasElements;
+    };
+
+    QIODevice *device = nullptr;
+    QByteArray *data = nullptr;
+    QByteArray buffer;          // output not yet written to the device
+    QVarLengthArray<Container, 16> containers;
+    bool compact = true;
+    bool nameWritten = false;
+    bool topLevelWritten = false;
+    bool failed = false;
+
+    QByteArray &output() { return data ? *data : buffer; }
+
+    void reset()
+    {
+        flush(true);
+        containers.clear();
+        nameWritten = topLevelWritten = failed = false;
+    }
+
+    void flush(bool force)
+    {
+        if (!device || buffer.isEmpty() || (!force && buffer.size() < FlushThreshold))
+            return;
+        if (device->write(buffer) != buffer.size())
+            failed = true;
+        buffer.clear();
+    }
+
+    void writeSeparator()
+    {
+        Container &c = containers.last();
+        QByteArray &out = output();
+        if (c.hasElements)
+            out += compact ? "," : ",\n";
+        c.hasElements = true;
+        if (!compact)
+            out += QByteArray(4 * containers.size(), ' ');
+    }
+
+    void beginValue()
+    {
+        if (containers.isEmpty()) {
+            // separate consecutive top-level values; indented output already
+            // ends each of them with a newline
+            if (topLevelWritten && compact)
+                output() += '\n';
+            return;
+        }
+        if (containers.last().type == '{') {
+            Q_ASSERT_X(nameWritten, "QJsonStreamWriter",
+                       "Values in an object must be preceded by writeName()");
+            nameWritten = false;
+            return;
+        }
+        writeSeparator();
+    }
+
+    void endValue()
+    {
+        if (containers.isEmpty()) {
+            topLevelWritten = true;
+            if (!compact)
+                output() += '\n';
+            flush(true);
+        } else {
+            flush(false);
+        }
+    }
+
+    void writeStart(char type)
+    {
+        beginValue();
+        QByteArray &out = output();
+        out += type;
+        if (!compact)
+            out += '\n';
+        containers.append({ type, false });
+    }
+
+    void writeEnd(char type)
+    {
+        Q_ASSERT_X(!containers.isEmpty() && containers.last().type == (type == ']' ? '[' : '{'),
+                   "QJsonStreamWriter", "Mismatched end of array or object");
+        Q_ASSERT_X(!nameWritten, "QJsonStreamWriter", "Missing value after writeName()");
+        const Container c = containers.last();
+        containers.removeLast();
+        QByteArray &out = output();
+        if (!compact) {
+            if (c.hasElements)
+                out += '\n';
+            out += QByteArray(4 * containers.size(), ' ');
+        }
+        out += type;
+        endValue();
+    }
+};
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.2
+
+    \brief The QJsonStreamWriter class writes JSON text one value at a time.
+
+    QJsonStreamWriter produces JSON incrementally, without building a
+    QJsonDocument for the whole output first. Arrays and objects are opened
+    with writeStartArray() and writeStartObject() and closed with
+    writeEndArray() and writeEndObject(). Inside an object, each value is
+    preceded by its name, written with writeName(); writeMember() does both in
+    one call. Any QJsonValue, including complete arrays and objects, can be
+    written with writeValue().
+
+    \snippet code/src_corelib_serialization_qjsonstream.cpp 1
+
+    The output is written either to a QIODevice, in chunks, or appended to a
+    QByteArray. It is formatted according to format(), and is byte for byte
+    the same as QJsonDocument::toJson() would produce for the same document.
+    Several values may be written one after the other at the top level; in
+    QJsonDocument::Compact format, they are separated by newlines, so that the
+    output is a stream of newline-delimited JSON records that
+    QJsonStreamReader can read back.
+
+    The writer does not validate the structure it is asked to produce beyond
+    assertions in debug builds: every writeStartArray() and writeStartObject()
+    must be matched by the corresponding end call, and values inside an object
+    must be preceded by a name.
+
+    \sa QJsonStreamReader, QJsonDocument::toJson(), QCborStreamWriter
+*/
+
+/*!
+    Constructs a QJsonStreamWriter without a device. Call setDevice() before
+    writing anything.
+*/
+QJsonStreamWriter::QJsonStreamWriter()
+    : d(new QJsonStreamWriterPrivate)
+{
+}
+
+/*!
+    Constructs a QJsonStreamWriter that writes to \a device. The device must
+    already be open for writing.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : QJsonStreamWriter()
+{
+    d->device = device;
+}
+
+/*!
+    Constructs a QJsonStreamWriter that appends its output to \a data.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *data)
+    : QJsonStreamWriter()
+{
+    d->data = data;
+}
+
+/*!
+    Destroys the writer, writing any buffered output to the device first. The
+    device is not closed.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+    d->flush(true);
+}
+
+/*!
+    Writes any buffered output to the current device, then makes the writer
+    write to \a device and resets it to the top level.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    d->reset();
+    d->device = device;
+    d->data = nullptr;
+}
+
+/*!
+    Returns the device the writer writes to, or \nullptr if it writes to a
+    QByteArray or has no device.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    return d->device;
+}
+
+/*!
+    Sets the output format to \a format. This should be done before writing
+    the first value; the default is QJsonDocument::Compact.
+
+    \sa format()
+*/
+void QJsonStreamWriter::setFormat(QJsonDocument::JsonFormat format)
+{
+    d->compact = format == QJsonDocument::Compact;
+}
+
+/*!
+    Returns the output format.
+
+    \sa setFormat()
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    return d->compact ? QJsonDocument::Compact : QJsonDocument::Indented;
+}
+
+/*!
+    Starts an array. Every following value is an element of the array until
+    writeEndArray() is called.
+
+    \sa writeEndArray(), writeStartObject()
+*/
+void QJsonStreamWriter::writeStartArray()
+{
+    d->writeStart('[');
+}
+
+/*!
+    Ends the array started by the matching writeStartArray().
+*/
+void QJsonStreamWriter::writeEndArray()
+{
+    d->writeEnd(']');
+}
+
+/*!
+    Starts an object. Until writeEndObject() is called, every following value
+    is a member of the object and must be preceded by writeName().
+
+    \sa writeEndObject(), writeMember()
+*/
+void QJsonStreamWriter::writeStartObject()
+{
+    d->writeStart('{');
+}
+
+/*!
+    Ends the object started by the matching writeStartObject().
+*/
+void QJsonStreamWriter::writeEndObject()
+{
+    d->writeEnd('}');
+}
+
+/*!
+    Writes \a name as the name of the next member of the current object. It
+    must be followed by exactly one value.
+
+    \sa writeMember(), writeValue()
+*/
+void QJsonStreamWriter::writeName(QStringView name)
+{
+    Q_ASSERT_X(!d->containers.isEmpty() && d->containers.last().type == '{',
+               "QJsonStreamWriter::writeName", "Names can only be written inside objects");
+    Q_ASSERT_X(!d->nameWritten, "QJsonStreamWriter::writeName", "Missing value after previous name");
+    d->writeSeparator();
+    QByteArray &out = d->output();
+    out += '"';
+    out += QJsonPrivate::Writer::escapedString(name);
+    out += d->compact ? "\":" : "\": ";
+    d->nameWritten = true;
+}
+
+/*!
+    Writes \a value, which may also be a complete array or object. An
+    undefined value is written as \c null.
+
+    \sa writeMember()
+*/
+void QJsonStreamWriter::writeValue(const QJsonValue &value)
+{
+    d->beginValue();
+    QJsonPrivate::Writer::valueToJson(QCborValue::fromJsonValue(value), d->output(),
+                                      d->compact ? 0 : d->containers.size(), d->compact);
+    d->endValue();
+}
+
+/*!
+    \fn void QJsonStreamWriter::writeMember(QStringView name, const QJsonValue &value)
+
+    Writes the member \a name with the value \a value in the current object.
+    This is the same as calling writeName() followed by writeValue().
+*/
+
+/*!
+    Returns the number of arrays and objects that have been started but not
+    yet ended.
+*/
+int QJsonStreamWriter::depth() const
+{
+    return d->containers.size();
+}
+
+/*!
+    Returns \c true if writing to the device failed.
+*/
+bool QJsonStreamWriter::hasError() const
+{
+    return d->failed;
+}
+
+QT_END_NAMESPACE
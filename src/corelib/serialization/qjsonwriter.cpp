@@ -58,15 +58,15 @@ static inline uchar hexdig(uint u)
     return (u < 0xa ? '0' + u : 'a' + u - 0xa);
 }
 
-static QByteArray escapedString(const QString &s)
+QByteArray Writer::escapedString(QStringView s)
 {
     // give it a minimum size to ensure the resize() below always adds enough space
-    QByteArray ba(qMax(s.length(), 16), Qt::Uninitialized);
+    QByteArray ba(qMax(s.length(), qsizetype(16)), Qt::Uninitialized);
 
     uchar *cursor = reinterpret_cast<uchar *>(const_cast<char *>(ba.constData()));
     const uchar *ba_end = cursor + ba.length();
-    const ushort *src = reinterpret_cast<const ushort *>(s.constBegin());
-    const ushort *const end = reinterpret_cast<const ushort *>(s.constEnd());
+    const ushort *src = reinterpret_cast<const ushort *>(s.begin());
+    const ushort *const end = reinterpret_cast<const ushort *>(s.end());
 
     while (src != end) {
         if (cursor >= ba_end - 6) {
@@ -128,7 +128,7 @@ static QByteArray escapedString(const QString &s)
     return ba;
 }
 
-static void valueToJson(const QCborValue &v, QByteArray &json, int indent, bool compact)
+void Writer::valueToJson(const QCborValue &v, QByteArray &json, int indent, bool compact)
 {
     QCborValue::Type type = v.type();
     switch (type) {
@@ -184,7 +184,7 @@ static void arrayContentToJson(const QCborContainerPrivate *a, QByteArray &json,
     qsizetype i = 0;
     while (true) {
         json += indentString;
-        valueToJson(a->valueAt(i), json, indent, compact);
+        Writer::valueToJson(a->valueAt(i), json, indent, compact);
 
         if (++i == a->elements.size()) {
             if (!compact)
@@ -209,9 +209,9 @@ static void objectContentToJson(const QCborContainerPrivate *o, QByteArray &json
         QCborValue e = o->valueAt(i);
         json += indentString;
         json += '"';
-        json += escapedString(o->valueAt(i).toString());
+        json += Writer::escapedString(o->valueAt(i).toString());
         json += compact ? "\":" : "\": ";
-        valueToJson(o->valueAt(i + 1), json, indent, compact);
+        Writer::valueToJson(o->valueAt(i + 1), json, indent, compact);
 
         if ((i += 2) == o->elements.size()) {
             if (!compact)
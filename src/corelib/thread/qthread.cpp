@@ -93,6 +93,7 @@ QThreadData::~QThreadData()
     thread.storeRelease(nullptr);
     delete t;
 
+    postEventList.takeIncomingEvents();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -105,6 +106,150 @@ QThreadData::~QThreadData()
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
+QPostEventList::~QPostEventList()
+{
+    for (IncomingBlock *block = incomingHead.loadRelaxed(); block; ) {
+        IncomingBlock *next = block->next.loadRelaxed();
+        delete block;
+        block = next;
+    }
+    for (IncomingBlock *block = retiredBlocks; block; ) {
+        IncomingBlock *next = block->retiredNext;
+        delete block;
+        block = next;
+    }
+}
+
+/*
+    Queues \a event for \a receiver without locking the mutex. Must be called
+    with producers incremented. Returns \c true if the thread needs to be woken
+    up to take the event.
+*/
+bool QPostEventList::pushIncomingEvent(QObject *receiver, QEvent *event)
+{
+    // The tail only moves to a block after a ticket in that block was handed
+    // out, so loading it before taking our ticket gives a block at or before
+    // the one holding the ticket.
+    IncomingBlock *tail = incomingTail.loadAcquire();
+    if (!tail) {
+        // first post to this thread
+        IncomingBlock *first = new IncomingBlock(0);
+        IncomingBlock *head = nullptr;
+        if (incomingHead.testAndSetOrdered(nullptr, first, head))
+            head = first;
+        else
+            delete first;
+        if (incomingTail.testAndSetOrdered(nullptr, head, tail))
+            tail = head;
+    }
+
+    // Handing out a ticket releases the events this thread published before,
+    // see takeIncomingEvents().
+    const quintptr ticket = nextTicket.fetchAndAddOrdered(1);
+
+    IncomingBlock *block = tail;
+    while (ticket - block->firstTicket >= quintptr(IncomingBlock::Size)) {
+        IncomingBlock *next = block->next.loadAcquire();
+        if (!next) {
+            auto *newBlock = new IncomingBlock(block->firstTicket + IncomingBlock::Size);
+            if (block->next.testAndSetOrdered(nullptr, newBlock, next))
+                next = newBlock;
+            else
+                delete newBlock;
+        }
+        block = next;
+    }
+    if (block != tail)
+        incomingTail.testAndSetRelease(tail, block);
+
+    IncomingBlock::Entry &entry = block->entries[ticket - block->firstTicket];
+    entry.receiver = receiver;
+    entry.event.storeRelease(event);
+
+    // pairs with the fence in takeIncomingEvents(): either it sees the event
+    // or we see that the thread needs to be woken up
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return needsWakeUp.loadRelaxed() && needsWakeUp.fetchAndStoreRelaxed(0);
+}
+
+/*
+    Moves the published events into the list, in the order they were posted.
+    Slots that have a ticket but were not published yet are skipped; their
+    producers will wake the thread up. Must be called with the mutex locked.
+*/
+void QPostEventList::takeIncomingEvents()
+{
+    needsWakeUp.storeRelaxed(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    quintptr ticket = takenTicket.loadRelaxed();
+    // Synchronizes with handing out the tickets before end, so every event
+    // published by a producer before it took one of them is visible. A
+    // skipped slot therefore never precedes a taken one from the same thread.
+    const quintptr end = nextTicket.loadAcquire();
+    if (ticket == end)
+        return;
+
+    IncomingBlock *head = incomingHead.loadRelaxed();
+    IncomingBlock *block = head;
+    bool allTaken = true;   // every slot before ticket has been taken
+    for (quintptr t = ticket; t != end; ++t) {
+        if (t - block->firstTicket == quintptr(IncomingBlock::Size)) {
+            IncomingBlock *next = block->next.loadAcquire();
+            if (!next)
+                break;
+            if (allTaken) {
+                block->retiredNext = retiredBlocks;
+                retiredBlocks = block;
+                head = next;
+            }
+            block = next;
+        }
+
+        IncomingBlock::Entry &entry = block->entries[t - block->firstTicket];
+        if (!entry.taken) {
+            QEvent *event = entry.event.loadAcquire();
+            if (!event) {
+                allTaken = false;
+                continue;
+            }
+            addEvent(QPostEvent(entry.receiver, event, Qt::NormalEventPriority));
+            QObjectPrivate *d = QObjectPrivate::get(entry.receiver);
+            ++d->postedEvents;
+            d->incomingEvents.deref();
+            entry.taken = true;
+        }
+        if (allTaken)
+            ticket = t + 1;
+    }
+    incomingHead.storeRelaxed(head);
+    takenTicket.storeRelease(ticket);
+
+    if (!retiredBlocks)
+        return;
+
+    // Producers may still be walking from a retired block, or have left the
+    // tail on one. Move the tail past them, then free them only if no
+    // producer is active; anyone starting later will load the new tail.
+    for (;;) {
+        IncomingBlock *tail = incomingTail.loadAcquire();
+        bool retired = false;
+        for (IncomingBlock *b = retiredBlocks; b && !retired; b = b->retiredNext)
+            retired = b == tail;
+        if (!retired)
+            break;
+        incomingTail.testAndSetOrdered(tail, head);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (producers.loadAcquire())
+        return;
+    while (retiredBlocks) {
+        IncomingBlock *next = retiredBlocks->retiredNext;
+        delete retiredBlocks;
+        retiredBlocks = next;
+    }
+}
+
 void QThreadData::ref()
 {
 #if QT_CONFIG(thread)
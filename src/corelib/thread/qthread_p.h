@@ -107,7 +107,51 @@ public:
 
     QMutex mutex;
 
+    // Events that never need to be compressed are queued here by
+    // QCoreApplication::postEvent() without locking the mutex, so that many
+    // threads posting to the same thread don't contend on it. The queue is a
+    // linked list of blocks, allocated on the first post; a producer takes a
+    // ticket, which selects a slot, and publishes the event in it.
+    // takeIncomingEvents() must be called with the mutex locked before
+    // anything looks at the list.
+    struct IncomingBlock
+    {
+        enum { Size = 127 };
+        struct Entry {
+            QObject *receiver;
+            QAtomicPointer<QEvent> event;   // null until published
+            bool taken;                     // moved into the list; mutex protected
+        };
+
+        explicit IncomingBlock(quintptr firstTicket) : firstTicket(firstTicket) { }
+
+        const quintptr firstTicket;
+        QAtomicPointer<IncomingBlock> next;
+        IncomingBlock *retiredNext = nullptr;
+        Entry entries[Size] = {};
+    };
+
+    QAtomicInteger<quintptr> nextTicket;        // next ticket to hand out
+    QAtomicInteger<quintptr> takenTicket;       // first ticket not moved into the list yet
+    QAtomicPointer<IncomingBlock> incomingTail; // at or before the block of nextTicket
+    QAtomicPointer<IncomingBlock> incomingHead; // block of takenTicket
+    IncomingBlock *retiredBlocks = nullptr;     // consumed, waiting to be freed
+    QAtomicInt needsWakeUp = 1;                 // set when the thread has taken all events
+
+    // number of postEvent() calls currently queueing, which may still be
+    // walking retired blocks
+    QAtomicInt producers;
+
     inline QPostEventList() : QList<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0) { }
+    ~QPostEventList();
+
+    bool hasIncomingEvents() const
+    {
+        return nextTicket.loadAcquire() != takenTicket.loadAcquire();
+    }
+
+    bool pushIncomingEvent(QObject *receiver, QEvent *event);
+    void takeIncomingEvents();
 
     void addEvent(const QPostEvent &ev)
     {
@@ -165,9 +209,14 @@ public:
 
     uint stackSize;
     QThread::Priority priority;
+    QList<int> cpuAffinity; // CPUs the thread may run on once started, empty for all
 
     static QThread *threadForId(int id);
 
+    static QList<int> availableCpus();
+    static QList<QList<int>> cpuCores();
+    static QList<QList<int>> numaNodes();
+
 #ifdef Q_OS_UNIX
     QWaitCondition thread_done;
 
@@ -257,7 +306,7 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasIncomingEvents();
     }
 
     // This class provides per-thread (by way of being a QThreadData
@@ -54,6 +54,9 @@
 #endif
 
 #include <private/qeventdispatcher_unix_p.h>
+#if QT_CONFIG(epoll)
+#  include <private/qeventdispatcher_epoll_p.h>
+#endif
 
 #include "qthreadstorage.h"
 
@@ -100,6 +103,14 @@
 #include <sys/neutrino.h>
 #endif
 
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && !defined(QT_LINUXBASE)
+#define QT_HAS_THREAD_AFFINITY
+// other C libraries, like musl, can only set the affinity of a running thread
+#  if defined(__GLIBC__)
+#    define QT_HAS_PTHREAD_ATTR_AFFINITY
+#  endif
+#endif
+
 QT_BEGIN_NAMESPACE
 
 #if QT_CONFIG(thread)
@@ -243,6 +254,10 @@ typedef void *(*QtThreadCallback)(void *);
 QAbstractEventDispatcher *QThreadPrivate::createEventDispatcher(QThreadData *data)
 {
     Q_UNUSED(data);
+#if QT_CONFIG(epoll)
+    if (QEventDispatcherEpoll::isRequested())
+        return new QEventDispatcherEpoll;
+#endif
 #if defined(Q_OS_DARWIN)
     bool ok = false;
     int value = qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_CORE_FOUNDATION", &ok);
@@ -278,6 +293,19 @@ static void setCurrentThreadName(const char *name)
 }
 #endif
 
+#ifdef QT_HAS_THREAD_AFFINITY
+// Fills \a set with the valid CPUs of \a cpus. Returns false if there are none.
+static bool cpuSetForAffinity(const QList<int> &cpus, cpu_set_t *set)
+{
+    CPU_ZERO(set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE)
+            CPU_SET(cpu, set);
+    }
+    return CPU_COUNT(set) > 0;
+}
+#endif
+
 void *QThreadPrivate::start(void *arg)
 {
 #if !defined(Q_OS_ANDROID)
@@ -305,6 +333,16 @@ void *QThreadPrivate::start(void *arg)
 
             data->ref();
             data->quitNow = thr->d_func()->exited;
+
+#if defined(QT_HAS_THREAD_AFFINITY) && !defined(QT_HAS_PTHREAD_ATTR_AFFINITY)
+            // it could not be set before the thread was created
+            cpu_set_t set;
+            if (!thr->d_func()->cpuAffinity.isEmpty()
+                    && cpuSetForAffinity(thr->d_func()->cpuAffinity, &set)
+                    && sched_setaffinity(0, sizeof(set), &set) != 0) {
+                qErrnoWarning(errno, "QThread::start: Cannot set the CPU affinity");
+            }
+#endif
         }
 
         data->ensureEventDispatcher();
@@ -494,6 +532,113 @@ int QThread::idealThreadCount() noexcept
     return cores;
 }
 
+#ifdef QT_HAS_THREAD_AFFINITY
+// Parses a list of CPUs as found in sysfs, like "0-3,8,10-11"
+static QList<int> readCpuList(const char *path)
+{
+    QList<int> cpus;
+    const int fd = qt_safe_open(path, O_RDONLY);
+    if (fd == -1)
+        return cpus;
+    char buffer[4096];
+    const qint64 size = qt_safe_read(fd, buffer, sizeof(buffer) - 1);
+    qt_safe_close(fd);
+    if (size <= 0)
+        return cpus;
+    buffer[size] = '\0';
+
+    const char *p = buffer;
+    while (*p >= '0' && *p <= '9') {
+        char *end;
+        const int first = int(strtol(p, &end, 10));
+        int last = first;
+        if (*end == '-')
+            last = int(strtol(end + 1, &end, 10));
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus.append(cpu);
+        p = *end == ',' ? end + 1 : end;
+    }
+    return cpus;
+}
+
+// Returns the groups of CPUs listed in the given sysfs files, restricted to
+// the ones available to the process
+static QList<QList<int>> cpuGroups(const QList<int> &available, const char *pathPattern,
+                                   const QList<int> &ids)
+{
+    QList<QList<int>> groups;
+    for (int id : ids) {
+        char path[128];
+        qsnprintf(path, sizeof(path), pathPattern, id);
+        QList<int> group;
+        for (int cpu : readCpuList(path)) {
+            if (available.contains(cpu))
+                group.append(cpu);
+        }
+        if (!group.isEmpty() && !groups.contains(group))
+            groups.append(group);
+    }
+    return groups;
+}
+#endif
+
+/*
+    Returns the CPUs the process may run on.
+*/
+QList<int> QThreadPrivate::availableCpus()
+{
+    QList<int> cpus;
+#ifdef QT_HAS_THREAD_AFFINITY
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set))
+                cpus.append(cpu);
+        }
+        return cpus;
+    }
+#endif
+    for (int cpu = 0; cpu < QThread::idealThreadCount(); ++cpu)
+        cpus.append(cpu);
+    return cpus;
+}
+
+/*
+    Returns the available CPUs grouped by physical core, so that the
+    hardware threads of one core end up in the same group.
+*/
+QList<QList<int>> QThreadPrivate::cpuCores()
+{
+    const QList<int> available = availableCpus();
+    QList<QList<int>> cores;
+#ifdef QT_HAS_THREAD_AFFINITY
+    cores = cpuGroups(available, "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list",
+                      available);
+#endif
+    if (cores.isEmpty()) {
+        for (int cpu : available)
+            cores.append(QList<int>{ cpu });
+    }
+    return cores;
+}
+
+/*
+    Returns the available CPUs grouped by NUMA node. Without NUMA support,
+    all CPUs are returned as one node.
+*/
+QList<QList<int>> QThreadPrivate::numaNodes()
+{
+    const QList<int> available = availableCpus();
+    QList<QList<int>> nodes;
+#ifdef QT_HAS_THREAD_AFFINITY
+    nodes = cpuGroups(available, "/sys/devices/system/node/node%d/cpulist",
+                      readCpuList("/sys/devices/system/node/online"));
+#endif
+    if (nodes.isEmpty())
+        nodes.append(available);
+    return nodes;
+}
+
 void QThread::yieldCurrentThread()
 {
     sched_yield();
@@ -705,6 +850,20 @@ void QThread::start(Priority priority)
         }
     }
 
+#ifdef QT_HAS_PTHREAD_ATTR_AFFINITY
+    bool affinitySet = false;
+    if (!d->cpuAffinity.isEmpty()) {
+        // an unusable set is reported by pthread_create(), don't fail because of it
+        cpu_set_t set;
+        if (cpuSetForAffinity(d->cpuAffinity, &set)) {
+            if (int code = pthread_attr_setaffinity_np(&attr, sizeof(set), &set))
+                qErrnoWarning(code, "QThread::start: Cannot set the CPU affinity");
+            else
+                affinitySet = true;
+        }
+    }
+#endif
+
 #ifdef Q_OS_INTEGRITY
     if (Q_LIKELY(objectName().isEmpty()))
         pthread_attr_setthreadname(&attr, metaObject()->className());
@@ -713,6 +872,20 @@ void QThread::start(Priority priority)
 #endif
     pthread_t threadId;
     int code = pthread_create(&threadId, &attr, QThreadPrivate::start, this);
+#ifdef QT_HAS_PTHREAD_ATTR_AFFINITY
+    if (code == EINVAL && affinitySet) {
+        // maybe none of the CPUs is available to the process; if the thread
+        // can't be created with the CPUs of the process either, it was
+        // something else
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0
+                && pthread_attr_setaffinity_np(&attr, sizeof(set), &set) == 0) {
+            code = pthread_create(&threadId, &attr, QThreadPrivate::start, this);
+            if (code == 0)
+                qWarning("QThread::start: Ignoring the CPU affinity, no CPU of it is available");
+        }
+    }
+#endif
     if (code == EPERM) {
         // caller does not have permission to set the scheduling
         // parameters/policy
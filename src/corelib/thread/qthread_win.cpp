@@ -383,6 +383,28 @@ int QThread::idealThreadCount() noexcept
     return sysinfo.dwNumberOfProcessors;
 }
 
+// CPU affinity is not supported yet, see QThreadPrivate::cpuAffinity
+QList<int> QThreadPrivate::availableCpus()
+{
+    QList<int> cpus;
+    for (int cpu = 0; cpu < QThread::idealThreadCount(); ++cpu)
+        cpus.append(cpu);
+    return cpus;
+}
+
+QList<QList<int>> QThreadPrivate::cpuCores()
+{
+    QList<QList<int>> cores;
+    for (int cpu : availableCpus())
+        cores.append(QList<int>{ cpu });
+    return cores;
+}
+
+QList<QList<int>> QThreadPrivate::numaNodes()
+{
+    return { availableCpus() };
+}
+
 void QThread::yieldCurrentThread()
 {
     SwitchToThread();
@@ -41,6 +41,8 @@
 #include "qthreadpool_p.h"
 #include "qdeadlinetimer.h"
 #include "qcoreapplication.h"
+#include "qvarlengtharray.h"
+#include "private/qthread_p.h"
 
 #include <algorithm>
 
@@ -60,8 +62,65 @@ public:
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // runnables started from this thread while work stealing is enabled
+    QMutex localMutex;
+    QList<QueuePage *> localQueue;
+    qsizetype workerIndex = 0;
+
+    int affinityGroup = -1; // index into manager->affinityGroups
 };
 
+static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+
+/*
+    Helpers for the priority ordered lists of pages used both by the
+    global queue and the threads' local queues.
+*/
+static inline bool comparePriority(int priority, const QueuePage *p)
+{
+    return p->priority() < priority;
+}
+
+static void enqueueRunnable(QList<QueuePage *> &queue, QRunnable *runnable, int priority)
+{
+    Q_ASSERT(runnable != nullptr);
+    for (QueuePage *page : qAsConst(queue)) {
+        if (page->priority() == priority && !page->isFull()) {
+            page->push(runnable);
+            return;
+        }
+    }
+    auto it = std::upper_bound(queue.constBegin(), queue.constEnd(), priority, comparePriority);
+    queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
+}
+
+static QRunnable *dequeueRunnable(QList<QueuePage *> &queue)
+{
+    Q_ASSERT(!queue.isEmpty());
+    QueuePage *page = queue.constFirst();
+    QRunnable *runnable = page->pop();
+    if (page->isFinished()) {
+        queue.removeFirst();
+        delete page;
+    }
+    return runnable;
+}
+
+static bool tryTakeRunnable(QList<QueuePage *> &queue, QRunnable *runnable)
+{
+    for (QueuePage *page : qAsConst(queue)) {
+        if (page->tryTake(runnable)) {
+            if (page->isFinished()) {
+                queue.removeOne(page);
+                delete page;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
 /*
     QThreadPool private class.
 */
@@ -81,6 +140,8 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    currentPoolThread = this;
+    int stealBackoff = 0; // ms to wait after failing to steal a local runnable
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -109,6 +170,12 @@ void QThreadPoolThread::run()
 
                 if (del)
                     delete r;
+
+                // continue with the runnables started by this one, if any,
+                // without going through the pool's lock
+                r = manager->takeLocalTask(this);
+                if (r)
+                    continue;
                 locker.relock();
             }
 
@@ -118,16 +185,26 @@ void QThreadPoolThread::run()
 
             if (manager->queue.isEmpty()) {
                 r = nullptr;
-                break;
-            }
-
-            QueuePage *page = manager->queue.first();
-            r = page->pop();
+                if (manager->localTaskCount.load() <= 0)
+                    break;
 
-            if (page->isFinished()) {
-                manager->queue.removeFirst();
-                delete page;
+                // help the other threads with their local runnables
+                locker.unlock();
+                r = manager->stealTask(this);
+                if (r) {
+                    stealBackoff = 0;
+                } else {
+                    // the runnables counted are being taken by their threads
+                    // right now: back off instead of spinning on the queues
+                    locker.relock();
+                    stealBackoff = qBound(1, stealBackoff * 2, 16);
+                    runnableReady.wait(locker.mutex(), QDeadlineTimer(stealBackoff));
+                }
+                continue;
             }
+
+            r = dequeueRunnable(manager->queue);
+            manager->updateQueuedPriority();
         } while (true);
 
         // if too many threads are active, expire this thread
@@ -135,19 +212,33 @@ void QThreadPoolThread::run()
         if (!expired) {
             manager->waitingThreads.enqueue(this);
             registerThreadInactive();
+
+            // A runnable might have been queued locally by another thread
+            // which did not see this one idle yet, see enqueueLocalTask().
+            manager->updateSpareThreads();
+            if (manager->localTaskCount.load() > 0 && manager->waitingThreads.removeOne(this)) {
+                ++manager->activeThreads;
+                manager->updateSpareThreads();
+                continue;
+            }
+
             // wait for work, exiting after the expiry timeout is reached
             runnableReady.wait(locker.mutex(), QDeadlineTimer(manager->expiryTimeout));
             ++manager->activeThreads;
             if (manager->waitingThreads.removeOne(this))
                 expired = true;
+            manager->updateSpareThreads();
             if (!manager->allThreads.contains(this)) {
                 registerThreadInactive();
+                manager->updateSpareThreads();
                 break;
             }
         }
         if (expired) {
+            manager->requeueLocalTasks(this);
             manager->expiredThreads.enqueue(this);
             registerThreadInactive();
+            manager->updateSpareThreads();
             break;
         }
     }
@@ -183,6 +274,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         // recycle an available thread
         enqueueTask(task);
         waitingThreads.takeFirst()->runnableReady.wakeOne();
+        updateSpareThreads();
         return true;
     }
 
@@ -194,7 +286,9 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         ++activeThreads;
 
         thread->runnable = task;
+        setThreadAffinity(thread);
         thread->start(threadPriority);
+        updateSpareThreads();
         return true;
     }
 
@@ -203,22 +297,10 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
     return true;
 }
 
-inline bool comparePriority(int priority, const QueuePage *p)
-{
-    return p->priority() < priority;
-}
-
 void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
 {
-    Q_ASSERT(runnable != nullptr);
-    for (QueuePage *page : qAsConst(queue)) {
-        if (page->priority() == priority && !page->isFull()) {
-            page->push(runnable);
-            return;
-        }
-    }
-    auto it = std::upper_bound(queue.constBegin(), queue.constEnd(), priority, comparePriority);
-    queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
+    enqueueRunnable(queue, runnable, priority);
+    updateQueuedPriority();
 }
 
 int QThreadPoolPrivate::activeThreadCount() const
@@ -244,6 +326,12 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
             delete page;
         }
     }
+    updateQueuedPriority();
+
+    // let new or idle threads help with the runnables queued locally
+    for (int n = localTaskCount.load(); n > 0 && startThreadForLocalTasks(); --n)
+        ;
+    updateSpareThreads();
 }
 
 bool QThreadPoolPrivate::tooManyThreadsActive() const
@@ -258,7 +346,6 @@ bool QThreadPoolPrivate::tooManyThreadsActive() const
 void QThreadPoolPrivate::startThread(QRunnable *runnable)
 {
     Q_Q(QThreadPool);
-    Q_ASSERT(runnable != nullptr);
     QScopedPointer<QThreadPoolThread> thread(new QThreadPoolThread(this));
     QString objectName;
     if (QString myName = q->objectName(); !myName.isEmpty())
@@ -269,8 +356,16 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     Q_ASSERT(!allThreads.contains(thread.data())); // if this assert hits, we have an ABA problem (deleted threads don't get removed here)
     allThreads.insert(thread.data());
     ++activeThreads;
+    updateSpareThreads();
+
+    {
+        QWriteLocker workersLocker(&workersLock);
+        thread->workerIndex = workers.size();
+        workers.append(thread.data());
+    }
 
     thread->runnable = runnable;
+    setThreadAffinity(thread.data());
     thread.take()->start(threadPriority);
 }
 
@@ -286,6 +381,7 @@ void QThreadPoolPrivate::reset()
     allThreadsCopy.swap(allThreads);
     expiredThreads.clear();
     waitingThreads.clear();
+    updateSpareThreads();
     mutex.unlock();
 
     for (QThreadPoolThread *thread : qAsConst(allThreadsCopy)) {
@@ -293,6 +389,10 @@ void QThreadPoolPrivate::reset()
             thread->runnableReady.wakeAll();
             thread->wait();
         }
+        {
+            QWriteLocker workersLocker(&workersLock);
+            workers.removeOne(thread);
+        }
         delete thread;
     }
 
@@ -342,6 +442,26 @@ void QThreadPoolPrivate::clear()
         }
         delete page;
     }
+    updateQueuedPriority();
+
+    if (localTaskCount.load() <= 0)
+        return;
+
+    QList<QRunnable *> toDelete;
+    {
+        QReadLocker workersLocker(&workersLock);
+        for (QThreadPoolThread *thread : qAsConst(workers)) {
+            QMutexLocker localLocker(&thread->localMutex);
+            while (!thread->localQueue.isEmpty()) {
+                QRunnable *r = dequeueRunnable(thread->localQueue);
+                --localTaskCount;
+                if (r->autoDelete())
+                    toDelete.append(r);
+            }
+        }
+    }
+    locker.unlock();
+    qDeleteAll(toDelete);
 }
 
 /*!
@@ -369,13 +489,19 @@ bool QThreadPool::tryTake(QRunnable *runnable)
         return false;
 
     QMutexLocker locker(&d->mutex);
-    for (QueuePage *page : qAsConst(d->queue)) {
-        if (page->tryTake(runnable)) {
-            if (page->isFinished()) {
-                d->queue.removeOne(page);
-                delete page;
+    if (tryTakeRunnable(d->queue, runnable)) {
+        d->updateQueuedPriority();
+        return true;
+    }
+
+    if (d->localTaskCount.load() > 0) {
+        QReadLocker workersLocker(&d->workersLock);
+        for (QThreadPoolThread *thread : qAsConst(d->workers)) {
+            QMutexLocker localLocker(&thread->localMutex);
+            if (tryTakeRunnable(thread->localQueue, runnable)) {
+                --d->localTaskCount;
+                return true;
             }
-            return true;
         }
     }
 
@@ -402,6 +528,185 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
         delete runnable;
 }
 
+/*!
+    \internal
+    Queues \a runnable in the local queue of the pool thread \a thread, which
+    must be the current thread.
+*/
+void QThreadPoolPrivate::enqueueLocalTask(QThreadPoolThread *thread, QRunnable *runnable, int priority)
+{
+    Q_ASSERT(thread == currentPoolThread && thread->manager == this);
+    {
+        QMutexLocker locker(&thread->localMutex);
+        enqueueRunnable(thread->localQueue, runnable, priority);
+        ++localTaskCount;
+    }
+
+    // A thread may have become idle since the caller checked; such a thread
+    // either sees the increment above or is seen here.
+    if (spareThreads.load() > 0) {
+        QMutexLocker locker(&mutex);
+        startThreadForLocalTasks();
+    }
+}
+
+/*!
+    \internal
+    Returns the next runnable from the local queue of \a thread, unless the
+    global queue holds runnables with a higher priority.
+*/
+QRunnable *QThreadPoolPrivate::takeLocalTask(QThreadPoolThread *thread)
+{
+    if (localTaskCount.load(std::memory_order_relaxed) <= 0)
+        return nullptr;
+
+    QMutexLocker locker(&thread->localMutex);
+    if (thread->localQueue.isEmpty()
+            || thread->localQueue.constFirst()->priority() < queuedPriority.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    --localTaskCount;
+    return dequeueRunnable(thread->localQueue);
+}
+
+/*!
+    \internal
+    Takes the first runnable of the first non-empty local queue, looking at
+    the threads following \a thief first.
+*/
+QRunnable *QThreadPoolPrivate::stealTask(QThreadPoolThread *thief)
+{
+    QReadLocker locker(&workersLock);
+    const qsizetype count = workers.size();
+    for (qsizetype i = 1; i <= count; ++i) {
+        QThreadPoolThread *victim = workers.at((thief->workerIndex + i) % count);
+        QMutexLocker localLocker(&victim->localMutex);
+        if (!victim->localQueue.isEmpty()) {
+            --localTaskCount;
+            return dequeueRunnable(victim->localQueue);
+        }
+    }
+    return nullptr;
+}
+
+/*!
+    \internal
+    Moves the runnables from the local queue of \a thread to the global queue.
+    Used when \a thread expires.
+*/
+void QThreadPoolPrivate::requeueLocalTasks(QThreadPoolThread *thread)
+{
+    QMutexLocker locker(&thread->localMutex);
+    while (!thread->localQueue.isEmpty()) {
+        QueuePage *page = thread->localQueue.takeFirst();
+        while (!page->isFinished()) {
+            enqueueRunnable(queue, page->pop(), page->priority());
+            --localTaskCount;
+        }
+        delete page;
+    }
+    updateQueuedPriority();
+}
+
+/*!
+    \internal
+    Wakes up or starts a thread without giving it a runnable, so that it
+    steals from the local queues. Returns \c false if no thread is available.
+*/
+bool QThreadPoolPrivate::startThreadForLocalTasks()
+{
+    bool started = true;
+    if (!waitingThreads.isEmpty()) {
+        waitingThreads.takeFirst()->runnableReady.wakeOne();
+    } else if (activeThreadCount() >= maxThreadCount) {
+        started = false;
+    } else if (!expiredThreads.isEmpty()) {
+        QThreadPoolThread *thread = expiredThreads.dequeue();
+        Q_ASSERT(thread->runnable == nullptr);
+        ++activeThreads;
+        setThreadAffinity(thread);
+        thread->start(threadPriority);
+    } else {
+        startThread();
+    }
+    updateSpareThreads();
+    return started;
+}
+
+void QThreadPoolPrivate::updateSpareThreads()
+{
+    spareThreads.store(maxThreadCount - activeThreadCount());
+}
+
+void QThreadPoolPrivate::updateQueuedPriority()
+{
+    queuedPriority.store(queue.isEmpty() ? INT_MIN : queue.constFirst()->priority(),
+                         std::memory_order_relaxed);
+}
+
+/*!
+    \internal
+    Computes the CPU sets the threads are distributed over from the
+    affinity policy and the CPU affinity.
+*/
+void QThreadPoolPrivate::updateAffinityGroups()
+{
+    affinityGroups.clear();
+
+    QList<QList<int>> groups;
+    switch (affinityPolicy) {
+    case QThreadPool::SharedAffinity:
+        break;
+    case QThreadPool::PerCoreAffinity:
+        groups = QThreadPrivate::cpuCores();
+        break;
+    case QThreadPool::PerNodeAffinity:
+        groups = QThreadPrivate::numaNodes();
+        break;
+    }
+
+    for (const QList<int> &group : qAsConst(groups)) {
+        QList<int> cpus;
+        for (int cpu : group) {
+            if (cpuAffinity.isEmpty() || cpuAffinity.contains(cpu))
+                cpus.append(cpu);
+        }
+        if (!cpus.isEmpty())
+            affinityGroups.append(cpus);
+    }
+
+    if (affinityGroups.isEmpty() && !cpuAffinity.isEmpty())
+        affinityGroups.append(cpuAffinity);
+}
+
+/*!
+    \internal
+    Restricts \a thread, which is about to be started, to the CPU set used
+    by the fewest running threads.
+*/
+void QThreadPoolPrivate::setThreadAffinity(QThreadPoolThread *thread)
+{
+    thread->affinityGroup = -1;
+
+    QList<int> cpus;
+    if (!affinityGroups.isEmpty()) {
+        QVarLengthArray<int, 64> load(affinityGroups.size());
+        std::fill(load.begin(), load.end(), 0);
+        for (const QThreadPoolThread *other : qAsConst(allThreads)) {
+            if (other->affinityGroup >= 0 && other->affinityGroup < load.size()
+                    && !expiredThreads.contains(const_cast<QThreadPoolThread *>(other))) {
+                ++load[other->affinityGroup];
+            }
+        }
+        thread->affinityGroup = int(std::min_element(load.cbegin(), load.cend()) - load.cbegin());
+        cpus = affinityGroups.at(thread->affinityGroup);
+    }
+
+    QThreadPrivate *d = static_cast<QThreadPrivate *>(QObjectPrivate::get(thread));
+    QMutexLocker locker(&d->mutex);
+    d->cpuAffinity = cpus;
+}
+
 /*!
     \class QThreadPool
     \inmodule QtCore
@@ -506,13 +811,25 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+
+    // keep runnables started by a busy pool thread close to it
+    if (d->workStealing.load(std::memory_order_relaxed)) {
+        QThreadPoolThread *thread = currentPoolThread;
+        if (thread && thread->manager == d && d->spareThreads.load() <= 0) {
+            d->enqueueLocalTask(thread, runnable, priority);
+            return;
+        }
+    }
+
     QMutexLocker locker(&d->mutex);
 
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
 
-        if (!d->waitingThreads.isEmpty())
+        if (!d->waitingThreads.isEmpty()) {
             d->waitingThreads.takeFirst()->runnableReady.wakeOne();
+            d->updateSpareThreads();
+        }
     }
 }
 
@@ -678,6 +995,7 @@ void QThreadPool::reserveThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     ++d->reservedThreads;
+    d->updateSpareThreads();
 }
 
 /*! \property QThreadPool::stackSize
@@ -748,6 +1066,7 @@ void QThreadPool::releaseThread()
     QMutexLocker locker(&d->mutex);
     --d->reservedThreads;
     d->tryToStartMoreThreads();
+    d->updateSpareThreads();
 }
 
 /*!
@@ -791,6 +1110,162 @@ bool QThreadPool::contains(const QThread *thread) const
     return d->allThreads.contains(const_cast<QThreadPoolThread *>(poolThread));
 }
 
+/*! \property QThreadPool::workStealingEnabled
+    \brief whether runnables started from the pool's threads are queued
+    per thread.
+    \since 6.2
+
+    By default, all runnables that cannot be started right away are kept in
+    a single queue shared by all threads of the pool. When many small
+    runnables are started from within other runnables, for instance when
+    recursively splitting work, accessing that queue can become a
+    bottleneck.
+
+    If this property is \c true and all threads of the pool are busy, a
+    runnable started from one of the pool's threads is queued in a queue
+    local to that thread instead. The thread runs these runnables once the
+    current one returns, while threads running out of work take ("steal")
+    runnables from the queues of other threads.
+
+    Priorities are respected within each local queue, and a thread prefers
+    runnables with a higher priority from the shared queue to the ones in
+    its local queue. As idle threads steal regardless of priority,
+    runnables from different threads may however run out of order.
+
+    The default value is \c false. Changing the value only affects
+    runnables started afterwards.
+
+    \sa start()
+*/
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealing.load(std::memory_order_relaxed);
+}
+
+void QThreadPool::setWorkStealingEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    d->workStealing.store(enabled, std::memory_order_relaxed);
+}
+
+/*!
+    \enum QThreadPool::AffinityPolicy
+    \since 6.2
+
+    This enum describes how the threads of a thread pool are distributed
+    over the CPUs of the system.
+
+    \value SharedAffinity All threads may run on any CPU in cpuAffinity(),
+           or on any CPU if it is empty.
+    \value PerCoreAffinity Each thread is restricted to one physical core,
+           that is, to the hardware threads of that core. The threads are
+           spread evenly over the cores.
+    \value PerNodeAffinity Each thread is restricted to the CPUs of one NUMA
+           node. The threads are spread evenly over the nodes.
+
+    \sa affinityPolicy, cpuAffinity
+*/
+
+/*! \property QThreadPool::affinityPolicy
+    \brief how the worker threads are distributed over the CPUs.
+    \since 6.2
+
+    Keeping a thread on the same core or NUMA node keeps the caches and
+    the memory it works on close to it. If cpuAffinity() is not empty,
+    only the cores and nodes containing CPUs from it are used, and each
+    thread is restricted to those CPUs.
+
+    Like stackSize and threadPriority, the value of the property is only
+    used when the thread pool starts threads. Changing it has no effect
+    for already running threads.
+
+    The default value is SharedAffinity.
+
+    \note CPU affinity is currently only supported on Linux. On other
+    platforms, the property has no effect.
+
+    \sa cpuAffinity, numaNodeCpus()
+*/
+void QThreadPool::setAffinityPolicy(AffinityPolicy policy)
+{
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    if (d->affinityPolicy == policy)
+        return;
+    d->affinityPolicy = policy;
+    d->updateAffinityGroups();
+}
+
+QThreadPool::AffinityPolicy QThreadPool::affinityPolicy() const
+{
+    Q_D(const QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    return d->affinityPolicy;
+}
+
+/*! \property QThreadPool::cpuAffinity
+    \brief the CPUs the worker threads may run on.
+    \since 6.2
+
+    CPUs are identified by their index as used by the operating system. An
+    empty list, the default, does not restrict the threads.
+
+    To keep work on one NUMA node, for instance for the map functions of
+    Qt Concurrent, create a thread pool per node, restrict each of them to
+    the CPUs returned by numaNodeCpus() and pass the pool for the node the
+    data lives on to QtConcurrent::run() or QtConcurrent::mapped().
+
+    The value of the property is only used when the thread pool starts
+    threads. Changing it has no effect for already running threads.
+
+    \note CPU affinity is currently only supported on Linux. On other
+    platforms, the property has no effect.
+
+    \sa affinityPolicy, numaNodeCpus()
+*/
+void QThreadPool::setCpuAffinity(const QList<int> &cpus)
+{
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    d->cpuAffinity = cpus;
+    d->updateAffinityGroups();
+}
+
+QList<int> QThreadPool::cpuAffinity() const
+{
+    Q_D(const QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    return d->cpuAffinity;
+}
+
+/*!
+    \since 6.2
+
+    Returns the number of NUMA nodes that have CPUs available to the
+    process. Returns 1 if the system does not support NUMA.
+
+    \sa numaNodeCpus()
+*/
+int QThreadPool::numaNodeCount()
+{
+    return int(QThreadPrivate::numaNodes().size());
+}
+
+/*!
+    \since 6.2
+
+    Returns the CPUs of the NUMA node \a node that are available to the
+    process, or an empty list if \a node is out of range. The nodes are
+    numbered from 0 to numaNodeCount() - 1.
+
+    \sa numaNodeCount(), cpuAffinity
+*/
+QList<int> QThreadPool::numaNodeCpus(int node)
+{
+    return QThreadPrivate::numaNodes().value(node);
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qthreadpool.cpp"
@@ -61,9 +61,19 @@ class Q_CORE_EXPORT QThreadPool : public QObject
     Q_PROPERTY(int activeThreadCount READ activeThreadCount)
     Q_PROPERTY(uint stackSize READ stackSize WRITE setStackSize)
     Q_PROPERTY(QThread::Priority threadPriority READ threadPriority WRITE setThreadPriority)
+    Q_PROPERTY(bool workStealingEnabled READ isWorkStealingEnabled WRITE setWorkStealingEnabled)
+    Q_PROPERTY(AffinityPolicy affinityPolicy READ affinityPolicy WRITE setAffinityPolicy)
+    Q_PROPERTY(QList<int> cpuAffinity READ cpuAffinity WRITE setCpuAffinity)
     friend class QFutureInterfaceBase;
 
 public:
+    enum AffinityPolicy {
+        SharedAffinity,
+        PerCoreAffinity,
+        PerNodeAffinity
+    };
+    Q_ENUM(AffinityPolicy)
+
     QThreadPool(QObject *parent = nullptr);
     ~QThreadPool();
 
@@ -89,6 +99,18 @@ public:
     void setThreadPriority(QThread::Priority priority);
     QThread::Priority threadPriority() const;
 
+    void setWorkStealingEnabled(bool enabled);
+    bool isWorkStealingEnabled() const;
+
+    void setAffinityPolicy(AffinityPolicy policy);
+    AffinityPolicy affinityPolicy() const;
+
+    void setCpuAffinity(const QList<int> &cpus);
+    QList<int> cpuAffinity() const;
+
+    static int numaNodeCount();
+    static QList<int> numaNodeCpus(int node);
+
     void reserveThread();
     void releaseThread();
 
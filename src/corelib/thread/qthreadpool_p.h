@@ -53,12 +53,17 @@
 //
 
 #include "QtCore/qmutex.h"
+#include "QtCore/qreadwritelock.h"
 #include "QtCore/qthread.h"
 #include "QtCore/qwaitcondition.h"
 #include "QtCore/qset.h"
 #include "QtCore/qqueue.h"
+#include "QtCore/qthreadpool.h"
 #include "private/qobject_p.h"
 
+#include <atomic>
+#include <limits.h>
+
 QT_REQUIRE_CONFIG(thread);
 
 QT_BEGIN_NAMESPACE
@@ -166,6 +171,17 @@ public:
     void stealAndRunRunnable(QRunnable *runnable);
     void deletePageIfFinished(QueuePage *page);
 
+    void enqueueLocalTask(QThreadPoolThread *thread, QRunnable *runnable, int priority);
+    QRunnable *takeLocalTask(QThreadPoolThread *thread);
+    QRunnable *stealTask(QThreadPoolThread *thief);
+    void requeueLocalTasks(QThreadPoolThread *thread);
+    bool startThreadForLocalTasks();
+    void updateSpareThreads();
+    void updateQueuedPriority();
+
+    void updateAffinityGroups();
+    void setThreadAffinity(QThreadPoolThread *thread);
+
     mutable QMutex mutex;
     QSet<QThreadPoolThread *> allThreads;
     QQueue<QThreadPoolThread *> waitingThreads;
@@ -179,6 +195,18 @@ public:
     int activeThreads = 0;
     uint stackSize = 0;
     QThread::Priority threadPriority = QThread::InheritPriority;
+    QThreadPool::AffinityPolicy affinityPolicy = QThreadPool::SharedAffinity;
+    QList<int> cpuAffinity;
+    QList<QList<int>> affinityGroups; // the CPU sets threads are distributed over
+
+    // work stealing: runnables started from a busy pool thread are queued
+    // in that thread's local queue, which idle threads can steal from
+    std::atomic<bool> workStealing = false;
+    QReadWriteLock workersLock;
+    QList<QThreadPoolThread *> workers; // protected by workersLock
+    std::atomic<int> localTaskCount = 0;
+    std::atomic<int> spareThreads = 0; // maxThreadCount - activeThreadCount()
+    std::atomic<int> queuedPriority = INT_MIN; // priority of the first page of queue
 };
 
 QT_END_NAMESPACE
@@ -2008,6 +2008,83 @@ size_t qHash(long double key, size_t seed) noexcept
 */
 
 
+/*! \fn template <class Key, class T> size_t QHash<Key, T>::hashKey(const Key &key) const
+    \since 6.2
+
+    Returns the hash value that this hash uses to locate \a key.
+
+    The value can be passed to findHashed(), constFindHashed(),
+    containsHashed() and insertHashed() to look up or insert the same key
+    repeatedly without hashing it again, which is useful for long keys
+    such as identifiers in a symbol table.
+
+    The result depends on the seed of the hash. Since all hashes are
+    created with the global seed, it can be cached alongside the key and
+    reused with any QHash that has the same key type, as long as
+    qSetGlobalQHashSeed() is not called in between.
+
+    \sa qHash()
+*/
+
+/*! \fn template <class Key, class T> QHash<Key, T>::iterator QHash<Key, T>::findHashed(const Key &key, size_t hash)
+    \since 6.2
+
+    Returns an iterator pointing to the item with the \a key in the
+    hash, using \a hash as the key's hash value instead of computing it.
+
+    \a hash must be the value returned by hashKey() for \a key, otherwise
+    the behavior is undefined.
+
+    \sa find(), hashKey()
+*/
+
+/*! \fn template <class Key, class T> QHash<Key, T>::const_iterator QHash<Key, T>::findHashed(const Key &key, size_t hash) const
+
+    \overload
+    \since 6.2
+*/
+
+/*! \fn template <class Key, class T> QHash<Key, T>::const_iterator QHash<Key, T>::constFindHashed(const Key &key, size_t hash) const
+    \since 6.2
+
+    Returns an iterator pointing to the item with the \a key in the
+    hash, using \a hash as the key's hash value instead of computing it.
+
+    \a hash must be the value returned by hashKey() for \a key, otherwise
+    the behavior is undefined.
+
+    \sa constFind(), hashKey()
+*/
+
+/*! \fn template <class Key, class T> bool QHash<Key, T>::containsHashed(const Key &key, size_t hash) const
+    \since 6.2
+
+    Returns \c true if the hash contains an item with the \a key, using
+    \a hash as the key's hash value instead of computing it; otherwise
+    returns \c false.
+
+    \a hash must be the value returned by hashKey() for \a key, otherwise
+    the behavior is undefined.
+
+    \sa contains(), hashKey()
+*/
+
+/*! \fn template <class Key, class T> QHash<Key, T>::iterator QHash<Key, T>::insertHashed(const Key &key, size_t hash, const T &value)
+    \since 6.2
+
+    Inserts a new item with the \a key and a value of \a value, using
+    \a hash as the key's hash value instead of computing it.
+
+    If there is already an item with the \a key, that item's value
+    is replaced with \a value.
+
+    \a hash must be the value returned by hashKey() for \a key, otherwise
+    the behavior is undefined.
+
+    \sa insert(), hashKey()
+*/
+
+
 /*! \fn template <class Key, class T> void QHash<Key, T>::insert(const QHash &other)
     \since 5.15
 
@@ -2680,6 +2757,76 @@ size_t qHash(long double key, size_t seed) noexcept
     \sa replace()
 */
 
+/*! \fn template <class Key, class T> size_t QMultiHash<Key, T>::hashKey(const Key &key) const
+    \since 6.2
+
+    Returns the hash value that this hash uses to locate \a key.
+
+    The value can be passed to findHashed(), constFindHashed(),
+    containsHashed() and insertHashed(). It can be reused with any
+    QMultiHash or QHash that has the same key type, see QHash::hashKey().
+
+    \sa qHash()
+*/
+
+/*! \fn template <class Key, class T> QMultiHash<Key, T>::iterator QMultiHash<Key, T>::findHashed(const Key &key, size_t hash)
+    \since 6.2
+
+    Returns an iterator pointing to the most recently inserted item with
+    the \a key, using \a hash as the key's hash value instead of computing
+    it.
+
+    \a hash must be the value returned by hashKey() for \a key, otherwise
+    the behavior is undefined.
+
+    \sa find(), hashKey()
+*/
+
+/*! \fn template <class Key, class T> QMultiHash<Key, T>::const_iterator QMultiHash<Key, T>::findHashed(const Key &key, size_t hash) const
+
+    \overload
+    \since 6.2
+*/
+
+/*! \fn template <class Key, class T> QMultiHash<Key, T>::const_iterator QMultiHash<Key, T>::constFindHashed(const Key &key, size_t hash) const
+    \since 6.2
+
+    Returns an iterator pointing to the most recently inserted item with
+    the \a key, using \a hash as the key's hash value instead of computing
+    it.
+
+    \a hash must be the value returned by hashKey() for \a key, otherwise
+    the behavior is undefined.
+
+    \sa constFind(), hashKey()
+*/
+
+/*! \fn template <class Key, class T> bool QMultiHash<Key, T>::containsHashed(const Key &key, size_t hash) const
+    \since 6.2
+
+    Returns \c true if the hash contains an item with the \a key, using
+    \a hash as the key's hash value instead of computing it; otherwise
+    returns \c false.
+
+    \a hash must be the value returned by hashKey() for \a key, otherwise
+    the behavior is undefined.
+
+    \sa contains(), hashKey()
+*/
+
+/*! \fn template <class Key, class T> QMultiHash<Key, T>::iterator QMultiHash<Key, T>::insertHashed(const Key &key, size_t hash, const T &value)
+    \since 6.2
+
+    Inserts a new item with the \a key and a value of \a value, using
+    \a hash as the key's hash value instead of computing it. Like insert(),
+    this adds an item even if there is already one with the same key.
+
+    \a hash must be the value returned by hashKey() for \a key, otherwise
+    the behavior is undefined.
+
+    \sa insert(), hashKey()
+*/
+
 /*!
     \fn template <class Key, class T> template <typename ...Args> QMultiHash<Key, T>::iterator QMultiHash<Key, T>::emplace(const Key &key, Args&&... args)
     \fn template <class Key, class T> template <typename ...Args> QMultiHash<Key, T>::iterator QMultiHash<Key, T>::emplace(Key &&key, Args&&... args)
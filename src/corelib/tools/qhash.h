@@ -487,8 +487,9 @@ struct Data
         bool resized = numBuckets != other.numBuckets;
         size_t nSpans = (numBuckets + Span::LocalBucketMask) / Span::NEntries;
         spans = new Span[nSpans];
+        size_t otherNSpans = (other.numBuckets + Span::LocalBucketMask) / Span::NEntries;
 
-        for (size_t s = 0; s < nSpans; ++s) {
+        for (size_t s = 0; s < otherNSpans; ++s) {
             const Span &span = other.spans[s];
             for (size_t index = 0; index < Span::NEntries; ++index) {
                 if (!span.hasNode(index))
@@ -585,9 +586,13 @@ struct Data
     }
 
     iterator find(const Key &key) const noexcept
+    {
+        return find(key, QHashPrivate::calculateHash(key, seed));
+    }
+
+    iterator find(const Key &key, size_t hash) const noexcept
     {
         Q_ASSERT(numBuckets > 0);
-        size_t hash = QHashPrivate::calculateHash(key, seed);
         size_t bucket = GrowthPolicy::bucketForHash(numBuckets, hash);
         // loop over the buckets until we find the entry we search for
         // or an empty slot, in which case we know the entry doesn't exist
@@ -613,7 +618,14 @@ struct Data
     {
         if (!size)
             return nullptr;
-        iterator it = find(key);
+        return findNode(key, QHashPrivate::calculateHash(key, seed));
+    }
+
+    Node *findNode(const Key &key, size_t hash) const noexcept
+    {
+        if (!size)
+            return nullptr;
+        iterator it = find(key, hash);
         if (it.isUnused())
             return nullptr;
         return it.node();
@@ -626,10 +638,15 @@ struct Data
     };
 
     InsertionResult findOrInsert(const Key &key) noexcept
+    {
+        return findOrInsert(key, QHashPrivate::calculateHash(key, seed));
+    }
+
+    InsertionResult findOrInsert(const Key &key, size_t hash) noexcept
     {
         if (shouldGrow())
             rehash(size + 1);
-        iterator it = find(key);
+        iterator it = find(key, hash);
         if (it.isUnused()) {
             spans[it.span()].insert(it.index());
             ++size;
@@ -1142,6 +1159,51 @@ public:
         return emplace(key, value);
     }
 
+    size_t hashKey(const Key &key) const noexcept
+    {
+        return QHashPrivate::calculateHash(key, d ? d->seed : size_t(qGlobalQHashSeed()));
+    }
+    iterator findHashed(const Key &key, size_t hash)
+    {
+        if (isEmpty()) // prevents detaching shared null
+            return end();
+        detach();
+        auto it = d->find(key, hash);
+        if (it.isUnused())
+            it = d->end();
+        return iterator(it);
+    }
+    const_iterator findHashed(const Key &key, size_t hash) const noexcept
+    {
+        if (isEmpty())
+            return end();
+        auto it = d->find(key, hash);
+        if (it.isUnused())
+            it = d->end();
+        return const_iterator(it);
+    }
+    const_iterator constFindHashed(const Key &key, size_t hash) const noexcept
+    {
+        return findHashed(key, hash);
+    }
+    bool containsHashed(const Key &key, size_t hash) const noexcept
+    {
+        if (!d)
+            return false;
+        return d->findNode(key, hash) != nullptr;
+    }
+    iterator insertHashed(const Key &key, size_t hash, const T &value)
+    {
+        if (isDetached()) {
+            // key and value may refer to an item of this hash, which
+            // inserting can move: copy them first
+            return insertHashed_helper(Key(key), hash, T(value));
+        }
+        const auto copy = *this; // keeps key and value alive across the detach
+        detach();
+        return insertHashed_helper(key, hash, value);
+    }
+
     void insert(const QHash &hash)
     {
         if (d == hash.d || !hash.d)
@@ -1183,6 +1245,18 @@ public:
     static size_t max_bucket_count() noexcept { return QHashPrivate::GrowthPolicy::maxNumBuckets(); }
 
     inline bool empty() const noexcept { return isEmpty(); }
+
+private:
+    template <typename K, typename V>
+    iterator insertHashed_helper(K &&key, size_t hash, V &&value)
+    {
+        auto result = d->findOrInsert(key, hash);
+        if (!result.initialized)
+            Node::createInPlace(result.it.node(), std::forward<K>(key), std::forward<V>(value));
+        else
+            result.it.node()->emplaceValue(std::forward<V>(value));
+        return iterator(result.it);
+    }
 };
 
 
@@ -1707,6 +1781,51 @@ public:
         return emplace(key, value);
     }
 
+    size_t hashKey(const Key &key) const noexcept
+    {
+        return QHashPrivate::calculateHash(key, d ? d->seed : size_t(qGlobalQHashSeed()));
+    }
+    iterator findHashed(const Key &key, size_t hash)
+    {
+        if (isEmpty())
+            return end();
+        detach();
+        auto it = d->find(key, hash);
+        if (it.isUnused())
+            it = d->end();
+        return iterator(it);
+    }
+    const_iterator findHashed(const Key &key, size_t hash) const noexcept
+    {
+        if (isEmpty())
+            return end();
+        auto it = d->find(key, hash);
+        if (it.isUnused())
+            it = d->end();
+        return const_iterator(it);
+    }
+    const_iterator constFindHashed(const Key &key, size_t hash) const noexcept
+    {
+        return findHashed(key, hash);
+    }
+    bool containsHashed(const Key &key, size_t hash) const noexcept
+    {
+        if (!d)
+            return false;
+        return d->findNode(key, hash) != nullptr;
+    }
+    iterator insertHashed(const Key &key, size_t hash, const T &value)
+    {
+        if (isDetached()) {
+            // key and value may refer to an item of this hash, which
+            // inserting can move: copy them first
+            return insertHashed_helper(Key(key), hash, T(value));
+        }
+        const auto copy = *this; // keeps key and value alive across the detach
+        detach();
+        return insertHashed_helper(key, hash, value);
+    }
+
     template <typename ...Args>
     iterator emplace(const Key &key, Args &&... args)
     {
@@ -1928,6 +2047,18 @@ private:
             delete d;
         d = dd;
     }
+
+    template <typename K, typename V>
+    iterator insertHashed_helper(K &&key, size_t hash, V &&value)
+    {
+        auto result = d->findOrInsert(key, hash);
+        if (!result.initialized)
+            Node::createInPlace(result.it.node(), std::forward<K>(key), std::forward<V>(value));
+        else
+            result.it.node()->insertMulti(std::forward<V>(value));
+        ++m_size;
+        return iterator(result.it);
+    }
 };
 
 Q_DECLARE_ASSOCIATIVE_FORWARD_ITERATOR(Hash)
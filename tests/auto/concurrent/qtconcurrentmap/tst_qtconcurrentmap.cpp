@@ -31,9 +31,12 @@
 
 #include <QThread>
 #include <QMutex>
+#include <QSemaphore>
 #include <QTest>
 #include <QRandomGenerator>
 
+#include <numeric>
+
 #include "../testhelper_functions.h"
 
 class tst_QtConcurrentMap : public QObject
@@ -54,6 +57,7 @@ private slots:
     void mappedReducedInitialValueThreadPool();
     void mappedReducedInitialValueWithMoveOnlyCallable();
     void mappedReducedDifferentTypeInitialValue();
+    void mappedReducedBoundedMemory();
     void assignResult();
     void functionOverloads();
     void noExceptFunctionOverloads();
@@ -1955,5 +1959,60 @@ void tst_QtConcurrentMap::persistentResultTest()
     QCOMPARE(ref.loadAcquire(), 3);
 }
 
+void tst_QtConcurrentMap::mappedReducedBoundedMemory()
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(2);
+
+    // While the reduce functor blocks, the other thread maps blocks until it
+    // is throttled. Only limiting the block size keeps it from mapping all of
+    // the input by then; use a small limit to keep the input small.
+    const int count = 4096;
+    const int blockSizeLimit = 8;
+    QList<int> list(count);
+    std::iota(list.begin(), list.end(), 0);
+
+    QSemaphore mapped;
+    QSemaphore reduceEntered;
+    QSemaphore reduceReleased;
+    bool blocked = false;
+    auto map = [&mapped](int x) {
+        mapped.release();
+        return x % 7;
+    };
+    auto reduce = [&](qint64 &sum, int value) {
+        if (!blocked) {
+            blocked = true;
+            reduceEntered.release();
+            reduceReleased.acquire();
+        }
+        sum += value;
+    };
+
+    using Reducer = ReduceKernel<decltype(reduce), qint64, int>;
+    using Kernel = MappedReducedKernel<qint64, QList<int>::const_iterator, decltype(map),
+                                       decltype(reduce), Reducer>;
+    auto kernel = new Kernel(&pool, list.constBegin(), list.constEnd(), map, reduce,
+                             OrderedReduce);
+    QCOMPARE(kernel->blockSizeLimit, int(ReduceBlockSizeLimit));
+    kernel->blockSizeLimit = blockSizeLimit;
+    QFuture<qint64> future = startThreadEngine(kernel).startAsynchronously();
+
+    // The other thread stops once more than ReduceQueueThrottleLimit blocks per
+    // thread are waiting to be reduced. On top of that, each thread holds the
+    // block it is mapping, and may insert one more while another is throttled.
+    QVERIFY(reduceEntered.tryAcquire(1, 10000));
+    const int bound = (ReduceQueueThrottleLimit + 2) * pool.maxThreadCount() * blockSizeLimit;
+    QVERIFY(bound < count);
+    const bool exceeded = mapped.tryAcquire(bound + 1, 500);
+    reduceReleased.release();
+
+    qint64 expected = 0;
+    for (int x : qAsConst(list))
+        expected += x % 7;
+    QCOMPARE(future.result(), expected);
+    QVERIFY2(!exceeded, "more results than expected were waiting to be reduced");
+}
+
 QTEST_MAIN(tst_QtConcurrentMap)
 #include "tst_qtconcurrentmap.moc"
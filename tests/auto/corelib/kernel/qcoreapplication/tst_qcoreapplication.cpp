@@ -531,6 +531,199 @@ void tst_QCoreApplication::deliverInDefinedOrder()
     QObject::connect(&obj, SIGNAL(done()), &app, SLOT(quit()));
     app.exec();
 }
+
+class SequenceEvent : public QEvent
+{
+public:
+    SequenceEvent(int producer, int sequence)
+        : QEvent(QEvent::User), producer(producer), sequence(sequence)
+    { }
+    int producer;
+    int sequence;
+};
+
+class SequenceRecorder : public QObject
+{
+public:
+    QList<int> lastSequence;
+    int received = 0;
+    int expected = 0;
+    bool inOrder = true;
+
+    void record(int producer, int sequence)
+    {
+        inOrder = inOrder && sequence == lastSequence.at(producer) + 1;
+        lastSequence[producer] = sequence;
+        if (++received == expected)
+            QCoreApplication::quit();
+    }
+
+    bool event(QEvent *e) override
+    {
+        if (e->type() != QEvent::User)
+            return QObject::event(e);
+        auto se = static_cast<SequenceEvent *>(e);
+        record(se->producer, se->sequence);
+        return true;
+    }
+};
+
+void tst_QCoreApplication::postFromMultipleThreads()
+{
+#if !QT_CONFIG(cxx11_future)
+    QSKIP("This test requires QThread::create");
+#else
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    // queued calls and other events posted by one thread are delivered in
+    // the order they were posted, regardless of how they were queued
+    const int producerCount = 4;
+    const int postsPerProducer = 10000;
+    SequenceRecorder recorder;
+    recorder.lastSequence.fill(-1, producerCount);
+    recorder.expected = producerCount * postsPerProducer;
+
+    QList<QThread *> producers;
+    for (int p = 0; p < producerCount; ++p) {
+        producers << QThread::create([&recorder, p] {
+            for (int i = 0; i < postsPerProducer; ++i) {
+                if (i % 10 == 0) {
+                    QCoreApplication::postEvent(&recorder, new SequenceEvent(p, i));
+                } else {
+                    QMetaObject::invokeMethod(&recorder, [&recorder, p, i] { recorder.record(p, i); },
+                                              Qt::QueuedConnection);
+                }
+            }
+        });
+        producers.last()->start();
+    }
+    QTimer::singleShot(60000, &app, &QCoreApplication::quit);
+    app.exec();
+    for (QThread *t : qAsConst(producers))
+        QVERIFY(t->wait());
+    qDeleteAll(producers);
+
+    QCOMPARE(recorder.received, recorder.expected);
+    QVERIFY(recorder.inOrder);
+
+    // queued calls can be removed and are removed when the receiver is destroyed
+    QThread *producer = QThread::create([&recorder] {
+        for (int i = 0; i < 100; ++i)
+            QMetaObject::invokeMethod(&recorder, [&recorder] { ++recorder.received; },
+                                      Qt::QueuedConnection);
+    });
+    producer->start();
+    QVERIFY(producer->wait());
+    delete producer;
+    QCoreApplication::removePostedEvents(&recorder, QEvent::MetaCall);
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(recorder.received, recorder.expected);
+
+    auto *doomed = new QObject;
+    for (int i = 0; i < 100; ++i)
+        QMetaObject::invokeMethod(doomed, [] { QFAIL("Event delivered to deleted object"); },
+                                  Qt::QueuedConnection);
+    delete doomed;
+    QCoreApplication::sendPostedEvents();
+#endif
+}
+
+void tst_QCoreApplication::moveToThreadWhilePosting()
+{
+#if !QT_CONFIG(cxx11_future)
+    QSKIP("This test requires QThread::create");
+#else
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    // events posted while the receiver moves follow it and keep their order
+    const int producerCount = 4;
+    const int postsPerProducer = 10000;
+    QThread worker;
+    worker.start();
+    SequenceRecorder recorder;
+    recorder.lastSequence.fill(-1, producerCount);
+    recorder.expected = producerCount * postsPerProducer;
+
+    QSemaphore started;
+    QList<QThread *> producers;
+    for (int p = 0; p < producerCount; ++p) {
+        producers << QThread::create([&recorder, &started, p] {
+            for (int i = 0; i < postsPerProducer; ++i) {
+                if (i == postsPerProducer / 10)
+                    started.release();
+                if (i % 10 == 0) {
+                    QCoreApplication::postEvent(&recorder, new SequenceEvent(p, i));
+                } else {
+                    QMetaObject::invokeMethod(&recorder, [&recorder, p, i] { recorder.record(p, i); },
+                                              Qt::QueuedConnection);
+                }
+            }
+        });
+        producers.last()->start();
+    }
+    started.acquire(producerCount);
+    recorder.moveToThread(&worker);
+
+    QTimer::singleShot(60000, &app, &QCoreApplication::quit);
+    app.exec();
+    for (QThread *t : qAsConst(producers))
+        QVERIFY(t->wait());
+    qDeleteAll(producers);
+    worker.quit();
+    QVERIFY(worker.wait());
+
+    QCOMPARE(recorder.received, recorder.expected);
+    QVERIFY(recorder.inOrder);
+#endif
+}
+
+class DeletionTrackingEvent : public QEvent
+{
+public:
+    explicit DeletionTrackingEvent(bool *deleted)
+        : QEvent(QEvent::MetaCall), deleted(deleted)
+    { }
+    ~DeletionTrackingEvent() { *deleted = true; }
+    bool *deleted;
+};
+
+void tst_QCoreApplication::removePostedEventsWithPendingPost()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    QPostEventList &list = QThreadData::current()->postEventList;
+    QObject pendingReceiver;
+    bool pendingDeleted = false;
+
+    // simulate another thread that took a ticket but did not publish its
+    // event yet; events queued after it must still be removed with their
+    // receiver
+    const quintptr pending = list.nextTicket.fetchAndAddOrdered(1);
+    bool deleted = false;
+    auto *receiver = new QObject;
+    QCoreApplication::postEvent(receiver, new DeletionTrackingEvent(&deleted));
+    delete receiver;
+    QVERIFY(deleted);
+    QVERIFY(list.hasIncomingEvents());
+
+    // now publish the pending event
+    QPostEventList::IncomingBlock *block = list.incomingHead.loadRelaxed();
+    while (pending - block->firstTicket >= quintptr(QPostEventList::IncomingBlock::Size))
+        block = block->next.loadAcquire();
+    QPostEventList::IncomingBlock::Entry &entry = block->entries[pending - block->firstTicket];
+    entry.receiver = &pendingReceiver;
+    entry.event.storeRelease(new DeletionTrackingEvent(&pendingDeleted));
+
+    QCoreApplication::removePostedEvents(&pendingReceiver, QEvent::MetaCall);
+    QVERIFY(pendingDeleted);
+    QVERIFY(!list.hasIncomingEvents());
+}
 #endif // QT_CONFIG(thread)
 
 void tst_QCoreApplication::applicationPid()
@@ -584,6 +777,13 @@ void tst_QCoreApplication::globalPostedEventsCount()
                           << 1
                           << 0;
     QCOMPARE(x.globalPostedEventsCount, expected);
+
+    // queued calls skip the post event list's mutex, but count all the same
+    QMetaObject::invokeMethod(&x, [] { }, Qt::QueuedConnection);
+    QMetaObject::invokeMethod(&x, [] { }, Qt::QueuedConnection);
+    QCOMPARE(qGlobalPostedEventsCount(), 2u);
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(qGlobalPostedEventsCount(), 0u);
 }
 
 class ProcessEventsAlwaysSendsPostedEventsObject : public QObject
@@ -45,6 +45,9 @@ private slots:
     void removePostedEvents();
 #if QT_CONFIG(thread)
     void deliverInDefinedOrder();
+    void postFromMultipleThreads();
+    void moveToThreadWhilePosting();
+    void removePostedEventsWithPendingPost();
 #endif
     void applicationPid();
     void globalPostedEventsCount();
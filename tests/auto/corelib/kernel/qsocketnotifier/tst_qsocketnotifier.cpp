@@ -32,6 +32,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QTimer>
+#include <QtCore/QAbstractEventDispatcher>
 #include <QtCore/QSocketNotifier>
 #include <QtNetwork/QTcpServer>
 #include <QtNetwork/QTcpSocket>
@@ -42,7 +43,18 @@
 #include <private/qnet_unix_p.h>
 #include <sys/select.h>
 #endif
+#include <algorithm>
 #include <limits>
+#include <memory>
+#include <vector>
+
+#ifdef USE_EPOLL_DISPATCHER
+static void useEpollDispatcher()
+{
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+}
+Q_CONSTRUCTOR_FUNCTION(useEpollDispatcher)
+#endif
 
 #if defined (Q_CC_MSVC) && defined(max)
 #  undef max
@@ -54,11 +66,15 @@ class tst_QSocketNotifier : public QObject
 {
     Q_OBJECT
 private slots:
+#ifdef USE_EPOLL_DISPATCHER
+    void initTestCase();
+#endif
     void constructing();
     void unexpectedDisconnection();
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
     void posixSockets();
+    void manyPipes();
 #endif
     void asyncMultipleDatagram();
     void activationReason_data();
@@ -360,6 +376,65 @@ void tst_QSocketNotifier::posixSockets()
     }
     qt_safe_close(posixSocket);
 }
+
+void tst_QSocketNotifier::manyPipes()
+{
+    // only the notifiers whose descriptors are ready may be activated,
+    // no matter how many others are registered with the event dispatcher
+    constexpr int PipeCount = 256;
+    int fds[PipeCount][2];
+    for (auto &pipe : fds)
+        QVERIFY(qt_safe_pipe(pipe, O_NONBLOCK) == 0);
+
+    std::vector<std::unique_ptr<QSocketNotifier>> notifiers;
+    std::vector<int> activations(PipeCount, 0);
+    for (int i = 0; i < PipeCount; ++i) {
+        notifiers.emplace_back(new QSocketNotifier(fds[i][0], QSocketNotifier::Read));
+        connect(notifiers.back().get(), &QSocketNotifier::activated, this,
+                [&activations, &fds, i](QSocketDescriptor socket) {
+            QCOMPARE(int(socket), fds[i][0]);
+            char c;
+            while (qt_safe_read(socket, &c, 1) == 1)
+                ;
+            if (++activations[i] == 1 && i == PipeCount - 1)
+                QTestEventLoop::instance().exitLoop();
+        });
+    }
+
+    const int ready[] = { 3, PipeCount / 2, PipeCount - 1 };
+    for (int i : ready)
+        QCOMPARE(qt_safe_write(fds[i][1], "x", 1), qint64(1));
+
+    QTestEventLoop::instance().enterLoop(5);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QCoreApplication::processEvents();
+
+    for (int i = 0; i < PipeCount; ++i) {
+        const bool expected = std::find(std::begin(ready), std::end(ready), i) != std::end(ready);
+        QCOMPARE(activations[i], expected ? 1 : 0);
+    }
+
+    // disabling a notifier must stop it from being activated
+    notifiers[3]->setEnabled(false);
+    QCOMPARE(qt_safe_write(fds[3][1], "x", 1), qint64(1));
+    QCOMPARE(qt_safe_write(fds[PipeCount - 1][1], "x", 1), qint64(1));
+    QTRY_COMPARE(activations[PipeCount - 1], 2);
+    QCOMPARE(activations[3], 1);
+
+    notifiers.clear();
+    for (auto &pipe : fds) {
+        qt_safe_close(pipe[0]);
+        qt_safe_close(pipe[1]);
+    }
+}
+#endif
+
+#ifdef USE_EPOLL_DISPATCHER
+void tst_QSocketNotifier::initTestCase()
+{
+    QCOMPARE(QAbstractEventDispatcher::instance()->metaObject()->className(),
+             "QEventDispatcherEpoll");
+}
 #endif
 
 void tst_QSocketNotifier::async_readDatagramSlot()
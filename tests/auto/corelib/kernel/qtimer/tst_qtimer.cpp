@@ -45,6 +45,9 @@
 #include <unistd.h>
 #endif
 
+#include <memory>
+#include <vector>
+
 class tst_QTimer : public QObject
 {
     Q_OBJECT
@@ -92,6 +95,9 @@ private slots:
 
     void bindToTimer();
     void bindTimer();
+
+    void manyTimers_data();
+    void manyTimers();
 };
 
 void tst_QTimer::zeroTimer()
@@ -824,7 +830,9 @@ public:
     static void quitEventLoop_noexcept() noexcept
     {
         QVERIFY(!_e.isNull());
-        _e->quit();
+        // Queue the quit: when called from another thread, it could otherwise
+        // arrive before _e->exec() was entered and get lost.
+        QMetaObject::invokeMethod(_e.data(), &QEventLoop::quit, Qt::QueuedConnection);
         if (_t)
             QCOMPARE(QThread::currentThread(), _t);
     }
@@ -1281,6 +1289,9 @@ static StaticSingleShotUser *s_staticSingleShotUser = nullptr;
 
 void tst_QTimer::initMain()
 {
+#ifdef USE_EPOLL_DISPATCHER
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+#endif
     s_staticSingleShotUser = new StaticSingleShotUser;
 }
 
@@ -1295,6 +1306,62 @@ void tst_QTimer::singleShot_static()
     QCOMPARE(s_staticSingleShotUser->helper.calls, s_staticSingleShotUser->calls());
 }
 
+void tst_QTimer::manyTimers_data()
+{
+    QTest::addColumn<Qt::TimerType>("timerType");
+    QTest::newRow("precise") << Qt::PreciseTimer;
+    QTest::newRow("coarse") << Qt::CoarseTimer;
+}
+
+void tst_QTimer::manyTimers()
+{
+    QFETCH(Qt::TimerType, timerType);
+
+    // timers with timeouts spread over several buckets of a timer wheel,
+    // some of which are stopped before they fire
+    constexpr int TimerCount = 2000;
+    std::vector<std::unique_ptr<QTimer>> timers;
+    std::vector<qint64> firedAfter(TimerCount, -1);
+    int remaining = 0;
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    for (int i = 0; i < TimerCount; ++i) {
+        auto timer = std::make_unique<QTimer>();
+        timer->setTimerType(timerType);
+        timer->setSingleShot(true);
+        timer->setInterval((i * 7) % 600);
+        connect(timer.get(), &QTimer::timeout, this, [&, i] {
+            firedAfter[i] = elapsed.elapsed();
+            --remaining;
+        });
+        timer->start();
+        timers.push_back(std::move(timer));
+        ++remaining;
+    }
+
+    for (int i = 0; i < TimerCount; i += 3) {
+        timers[i]->stop();
+        --remaining;
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(remaining, 0, 5000);
+    for (int i = 0; i < TimerCount; ++i) {
+        if (i % 3 == 0) {
+            QCOMPARE(firedAfter[i], -1);
+        } else {
+            // coarse timers may fire up to 5%, or a few milliseconds for
+            // short intervals, early
+            const qint64 interval = timers[i]->interval();
+            const qint64 earliest = timerType == Qt::PreciseTimer
+                    ? interval : interval - qMax(interval / 20, qint64(3)) - 1;
+            QVERIFY2(firedAfter[i] >= earliest,
+                     qPrintable(QString::fromLatin1("timer %1 with interval %2 fired after %3 ms")
+                                .arg(i).arg(interval).arg(firedAfter[i])));
+        }
+    }
+}
+
 QTEST_MAIN(tst_QTimer)
 
 #include "tst_qtimer.moc"
@@ -35,6 +35,7 @@ QT_WARNING_DISABLE_DEPRECATED
 #include "qjsonvalue.h"
 #include "qjsondocument.h"
 #include "qregularexpression.h"
+#include "qtemporaryfile.h"
 #include "private/qnumeric_p.h"
 #include <limits>
 
@@ -106,8 +107,10 @@ private Q_SLOTS:
     void toJsonLargeNumericValues();
     void fromJson();
     void fromJsonErrors();
+    void fromJsonFile();
     void parseNumbers();
     void parseStrings();
+    void parseLongStrings();
     void parseDuplicateKeys();
     void testParser();
 
@@ -2273,6 +2276,103 @@ void tst_QtJson::parseStrings()
 
 }
 
+void tst_QtJson::fromJsonFile()
+{
+    QFile testFile(testDataDir + "/test.json");
+    QVERIFY(testFile.open(QFile::ReadOnly));
+    const QByteArray testJson = testFile.readAll();
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJsonFile(testDataDir + "/test.json", &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(doc, QJsonDocument::fromJson(testJson));
+    QCOMPARE(doc.toJson(), QJsonDocument::fromJson(testJson).toJson());
+
+    const QByteArray json =
+            "{ \"a key that is long enough\": [\"a value that is long enough\", \"\\u00e9scaped\"],"
+            "  \"B\": \"Bj\xc3\xb8rn \xc3\xa9t\xc3\xa9 \xc3\xbc" "ber\","
+            "  \"B\": \"the last duplicate key wins\" }";
+    {
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        QCOMPARE(file.write(json), json.size());
+        file.close();
+        doc = QJsonDocument::fromJsonFile(file.fileName(), &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+    }
+    // the mapping outlives the file being removed
+    QCOMPARE(doc, QJsonDocument::fromJson(json));
+
+    QJsonObject o = doc.object();
+    QCOMPARE(o.keys(), QStringList({ "B", "a key that is long enough" }));
+    QCOMPARE(o.value("B").toString(), QLatin1String("the last duplicate key wins"));
+    QJsonArray a = o.take("a key that is long enough").toArray();
+    QCOMPARE(a.at(0).toString(), QLatin1String("a value that is long enough"));
+    QCOMPARE(a.at(1).toString(), QString::fromUtf8("\xc3\xa9scaped"));
+    a.append(a.at(0));
+    a[0] = o.value("B");
+    o.insert(a.at(2).toString(), a);
+    QCOMPARE(o.value("a value that is long enough").toArray().at(0).toString(),
+             QLatin1String("the last duplicate key wins"));
+
+    // values keep the mapping alive on their own
+    const QJsonValue v = a.at(2);
+    doc = QJsonDocument();
+    o = QJsonObject();
+    a = QJsonArray();
+    QCOMPARE(v.toString(), QLatin1String("a value that is long enough"));
+
+    doc = QJsonDocument::fromJsonFile(testDataDir + "/does-not-exist.json", &error);
+    QCOMPARE(error.error, QJsonParseError::FileError);
+    QVERIFY(doc.isNull());
+}
+
+void tst_QtJson::parseLongStrings()
+{
+    // the parser scans strings and whitespace in blocks of 16 or 32 bytes, so
+    // place the interesting characters at every offset around those blocks
+    struct Special {
+        const char *in;
+        const char *out;
+    };
+    const Special specials[] = {
+        { "\\\"", "\"" },
+        { "\\u0041", "A" },
+        { "\\n", "\n" },
+        { UNICODE_DJE, UNICODE_DJE },
+        { "\x7f", "\x7f" },
+        { "\x01", "\x01" }
+    };
+
+    for (const Special &special : specials) {
+        for (int length = 0; length < 70; ++length) {
+            for (int pos = 0; pos <= length; pos += (length < 40 ? 1 : 7)) {
+                QByteArray in(length, 'x');
+                QByteArray out = in;
+                in.insert(pos, special.in);
+                out.insert(pos, special.out);
+
+                const QByteArray indent(pos, ' ');
+                const QByteArray json = "[" + indent + "\"" + in + "\"," + indent + "\"" + in + "\"]";
+                QJsonParseError error;
+                QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+                QVERIFY2(error.error == QJsonParseError::NoError, json.constData());
+                QCOMPARE(doc.array().size(), 2);
+                QCOMPARE(doc.array().at(0).toString(), QString::fromUtf8(out));
+                QCOMPARE(doc.array().at(1).toString(), QString::fromUtf8(out));
+            }
+        }
+
+        // unterminated strings
+        for (int length = 0; length < 40; ++length) {
+            const QByteArray json = "[\"" + QByteArray(length, 'x') + special.in;
+            QJsonParseError error;
+            QJsonDocument::fromJson(json, &error);
+            QVERIFY(error.error != QJsonParseError::NoError);
+        }
+    }
+}
+
 void tst_QtJson::parseDuplicateKeys()
 {
     const char *json = "{ \"B\": true, \"A\": null, \"B\": false }";
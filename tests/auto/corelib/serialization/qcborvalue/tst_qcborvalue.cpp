@@ -40,6 +40,7 @@
 #include <QtCore/qcborvalue.h>
 #include <QTest>
 #include <QBuffer>
+#include <QTemporaryFile>
 #include <QCborStreamReader>
 #include <QCborStreamWriter>
 #include <QtEndian>
@@ -110,6 +111,9 @@ private slots:
     void fromCborStreamReaderByteArray();
     void fromCborStreamReaderIODevice_data() { fromCbor_data(); }
     void fromCborStreamReaderIODevice();
+    void fromCborFile_data() { fromCbor_data(); }
+    void fromCborFile();
+    void fromCborFileStrings();
     void validation_data();
     void validation();
     void extendedTypeValidation_data();
@@ -1992,6 +1996,72 @@ void tst_QCborValue::fromCborStreamReaderIODevice()
     fromCbor_common(doCheck);
 }
 
+void tst_QCborValue::fromCborFile()
+{
+    auto doCheck = [](const QCborValue &expected, const QByteArray &data) {
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        QCOMPARE(file.write(data), data.size());
+        file.close();
+
+        QCborParserError error;
+        QCborValue decoded = QCborValue::fromCborFile(file.fileName(), &error);
+        QVERIFY2(error.error == QCborError(), qPrintable(error.errorString()));
+        QCOMPARE(error.offset, data.size());
+        QVERIFY(decoded == expected);
+        QVERIFY(expected == decoded);
+    };
+
+    fromCbor_common(doCheck);
+}
+
+void tst_QCborValue::fromCborFileStrings()
+{
+    const QString text = QStringLiteral("a string long enough to be referred to");
+    const QByteArray bytes = "a byte array long enough to be referred to";
+    const QCborMap expected = {
+        { text, QCborArray{ bytes, text, 1 }.toCborValue() },
+        { QStringLiteral("Bj\u00f8rn \u00e9t\u00e9 \u00fcber"), QCborValue(QDateTime::fromMSecsSinceEpoch(0, Qt::UTC)) },
+        { QStringLiteral("short"), QCborValue(QUrl("https://example.com/some/long/path")) }
+    };
+
+    QCborValue decoded;
+    {
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        QVERIFY(file.write(expected.toCborValue().toCbor()) > 0);
+        file.close();
+
+        QCborParserError error;
+        decoded = QCborValue::fromCborFile(file.fileName(), &error);
+        QCOMPARE(error.error, QCborError::NoError);
+    }
+    // the mapping outlives the file being removed
+    QCOMPARE(decoded, QCborValue(expected));
+
+    QCborMap map = decoded.toMap();
+    QCborArray array = map.take(text).toArray();
+    QCOMPARE(array.at(0).toByteArray(), bytes);
+    QCOMPARE(array.at(1).toString(), text);
+    array[0] = array.at(1);
+    array[1] = QCborValue(bytes);
+    QCOMPARE(array, (QCborArray{ text, bytes, 1 }));
+    map.insert(array.at(0), array.extract(array.begin() + 1));
+    QCOMPARE(map.value(text), QCborValue(bytes));
+
+    // values keep the mapping alive on their own
+    QCborValue url = map.value(QStringLiteral("short"));
+    decoded = QCborValue();
+    map = QCborMap();
+    array = QCborArray();
+    QCOMPARE(url.toUrl(), QUrl("https://example.com/some/long/path"));
+
+    QCborParserError error;
+    decoded = QCborValue::fromCborFile(QStringLiteral("/this/file/does/not/exist.cbor"), &error);
+    QCOMPARE(error.error, QCborError::InputOutputError);
+    QVERIFY(decoded.isUndefined());
+}
+
 #include "../cborlargedatavalidation.cpp"
 
 void tst_QCborValue::validation_data()
@@ -0,0 +1,573 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/qjsonstreamreader.h>
+#include <QtCore/qjsonstreamwriter.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonobject.h>
+#include <QTest>
+#include <QBuffer>
+
+typedef QList<QJsonStreamReader::TokenType> TokenList;
+
+class tst_QJsonStream : public QObject
+{
+    Q_OBJECT
+private slots:
+    void tokens_data();
+    void tokens();
+    void incremental_data() { tokens_data(); }
+    void incremental();
+    void device();
+    void endOfInput();
+    void values();
+    void multipleTopLevelValues();
+    void readValue();
+    void readValueIncremental();
+    void errors_data();
+    void errors();
+    void writer_data();
+    void writer();
+    void writerMultipleTopLevelValues();
+    void writerDevice();
+};
+
+static QJsonStreamReader::TokenType readAll(QJsonStreamReader &reader, TokenList *tokens)
+{
+    QJsonStreamReader::TokenType t;
+    while ((t = reader.readNext()) != QJsonStreamReader::NoToken
+           && t != QJsonStreamReader::Invalid) {
+        tokens->append(t);
+    }
+    return t;
+}
+
+void tst_QJsonStream::tokens_data()
+{
+    using T = QJsonStreamReader;
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<TokenList>("expected");
+
+    QTest::newRow("empty") << QByteArray() << TokenList();
+    QTest::newRow("whitespace") << QByteArray(" \r\n\t") << TokenList();
+    QTest::newRow("emptyArray") << QByteArray("[]") << TokenList{ T::StartArray, T::EndArray };
+    QTest::newRow("emptyObject") << QByteArray("{ }") << TokenList{ T::StartObject, T::EndObject };
+    QTest::newRow("array")
+            << QByteArray("[1, -2.5e3, \"x\", true, false, null]")
+            << TokenList{ T::StartArray, T::Number, T::Number, T::String, T::Bool, T::Bool,
+                          T::Null, T::EndArray };
+    QTest::newRow("object")
+            << QByteArray("{\"a\": [ {} ], \"b\" : {\"c\":null}}")
+            << TokenList{ T::StartObject, T::Name, T::StartArray, T::StartObject, T::EndObject,
+                          T::EndArray, T::Name, T::StartObject, T::Name, T::Null, T::EndObject,
+                          T::EndObject };
+    QTest::newRow("bom") << QByteArray("\xef\xbb\xbf[]") << TokenList{ T::StartArray, T::EndArray };
+    QTest::newRow("scalars") << QByteArray("\"s\" true null 1.5\n")
+                             << TokenList{ T::String, T::Bool, T::Null, T::Number };
+}
+
+void tst_QJsonStream::tokens()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(TokenList, expected);
+
+    QJsonStreamReader reader(json);
+    TokenList tokens;
+    QCOMPARE(readAll(reader, &tokens), QJsonStreamReader::NoToken);
+    QCOMPARE(tokens, expected);
+    QVERIFY(!reader.hasError());
+    QVERIFY(reader.atEnd());
+    QCOMPARE(reader.depth(), 0);
+}
+
+void tst_QJsonStream::incremental()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(TokenList, expected);
+
+    // feed the data one byte at a time; every token must still come out once
+    QJsonStreamReader reader;
+    TokenList tokens;
+    for (char c : qAsConst(json)) {
+        reader.addData(&c, 1);
+        QJsonStreamReader::TokenType t = readAll(reader, &tokens);
+        if (t == QJsonStreamReader::Invalid)
+            QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+    }
+
+    QCOMPARE(readAll(reader, &tokens), QJsonStreamReader::NoToken);
+    QCOMPARE(tokens, expected);
+}
+
+void tst_QJsonStream::device()
+{
+    // more than the reader's internal chunk size, with long strings crossing chunk boundaries
+    QByteArray json = "[";
+    const QByteArray longString(100000, 'x');
+    for (int i = 0; i < 100; ++i)
+        json += "{\"i\":" + QByteArray::number(i) + ",\"s\":\"" + longString + "\"},";
+    json += "12345]";
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+        QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+        QCOMPARE(reader.text(), QLatin1String("i"));
+        QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+        QCOMPARE(reader.toInteger(), i);
+        QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+        QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+        QCOMPARE(reader.text().size(), longString.size());
+        QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    }
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QCOMPARE(reader.currentOffset(), json.size());
+
+    // top-level number terminated by the end of a random-access device
+    QByteArray number("42");
+    QBuffer numberBuffer(&number);
+    QVERIFY(numberBuffer.open(QIODevice::ReadOnly));
+    reader.setDevice(&numberBuffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), 42);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+}
+
+// delivers at most chunkSize bytes per read
+class SequentialBuffer : public QIODevice
+{
+public:
+    explicit SequentialBuffer(QByteArray *data, qint64 chunkSize = std::numeric_limits<qint64>::max())
+        : data(data), chunkSize(chunkSize) {}
+    bool isSequential() const override { return true; }
+    bool open(OpenMode mode) override { offset = 0; return QIODevice::open(mode); }
+    qint64 bytesAvailable() const override
+    { return data->size() - offset + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *out, qint64 maxSize) override
+    {
+        const qint64 n = qMin(qMin(maxSize, chunkSize), qint64(data->size() - offset));
+        memcpy(out, data->constData() + offset, n);
+        offset += n;
+        return n;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray *data;
+    qint64 chunkSize;
+    qsizetype offset = 0;
+};
+
+void tst_QJsonStream::endOfInput()
+{
+    // a top-level number is only complete once the reader knows no more data follows
+    QJsonStreamReader reader(QByteArray("42"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), 42);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+
+    reader.addData(" 1");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+    reader.addData("7");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    reader.setEndOfInput();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), 17);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.hasError());
+
+    QJsonStreamReader incremental;
+    incremental.addData("[1] -2.5");
+    QCOMPARE(incremental.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(incremental.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(incremental.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(incremental.readNext(), QJsonStreamReader::Invalid);
+    incremental.setEndOfInput();
+    QCOMPARE(incremental.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(incremental.toDouble(), -2.5);
+    QCOMPARE(incremental.readNext(), QJsonStreamReader::NoToken);
+
+    // sequential devices, such as sockets and processes
+    QByteArray number("42");
+    SequentialBuffer sequential(&number);
+    QVERIFY(sequential.open(QIODevice::ReadOnly));
+    reader.setDevice(&sequential);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+    reader.setEndOfInput();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), 42);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+
+    sequential.close();
+    QVERIFY(sequential.open(QIODevice::ReadOnly));
+    reader.setDevice(&sequential);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    sequential.close();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), 42);
+}
+
+void tst_QJsonStream::values()
+{
+    QJsonStreamReader reader(QByteArray(
+            "[\"a\\u00e9\\n\\\"\", \"\xe2\x82\xac\", 9223372036854775807, 9223372036854775808, "
+            "-0, 2.5, 1e2, true, false, null]"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.value(), QJsonValue(QJsonValue::Undefined));
+    QCOMPARE(reader.depth(), 1);
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), QString::fromUtf8("a\xc3\xa9\n\""));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), QString(QChar(0x20ac)));
+    QCOMPARE(reader.value(), QJsonValue(QString(QChar(0x20ac))));
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QVERIFY(reader.isInteger());
+    QCOMPARE(reader.toInteger(), std::numeric_limits<qint64>::max());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QVERIFY(!reader.isInteger());
+    QCOMPARE(reader.toDouble(), 9223372036854775808.);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QVERIFY(reader.isInteger());
+    QCOMPARE(reader.toInteger(), 0);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toDouble(), 2.5);
+    QCOMPARE(reader.toInteger(), 0);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QVERIFY(!reader.isInteger());
+    QCOMPARE(reader.toInteger(), 100);
+    QCOMPARE(reader.value(), QJsonValue(100));
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Bool);
+    QVERIFY(reader.toBool());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Bool);
+    QVERIFY(!reader.toBool());
+    QCOMPARE(reader.value(), QJsonValue(false));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Null);
+    QCOMPARE(reader.value(), QJsonValue(QJsonValue::Null));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.depth(), 0);
+}
+
+void tst_QJsonStream::multipleTopLevelValues()
+{
+    // newline-delimited JSON
+    QJsonStreamReader reader(QByteArray("{\"id\":1}\n{\"id\":2}\n"));
+    for (int i = 1; i <= 2; ++i) {
+        QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+        QCOMPARE(reader.readValue(), QJsonValue(QJsonObject{ { "id", i } }));
+        QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    }
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+
+    // more records arriving later
+    reader.addData("[3]");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QVERIFY(!reader.atEnd());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+}
+
+void tst_QJsonStream::readValue()
+{
+    const QByteArray json = "{\"skip\": 1, \"data\": {\"a\": [1, \"]}\\\"\", {\"b\": null}], \"c\": {}},"
+                            " \"after\": true}";
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.readValue(), QJsonValue(1));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.text(), QLatin1String("data"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+
+    const QJsonValue value = reader.readValue();
+    const QJsonValue expected = QJsonDocument::fromJson(
+            "{\"a\": [1, \"]}\\\"\", {\"b\": null}], \"c\": {}}").object();
+    QCOMPARE(value, expected);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 1);
+
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.text(), QLatin1String("after"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Bool);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.hasError());
+
+    // the whole document
+    QJsonStreamReader whole(json);
+    QCOMPARE(whole.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(whole.readValue(), QJsonValue(QJsonDocument::fromJson(json).object()));
+    QCOMPARE(whole.readNext(), QJsonStreamReader::NoToken);
+}
+
+void tst_QJsonStream::readValueIncremental()
+{
+    // every chunk boundary, including one right after a backslash
+    const QByteArray json = "[[1, 2, {\"x\": \"]\\\"]\"}], 3]";
+    QJsonStreamReader reader;
+    reader.addData(json.left(2));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+
+    for (int i = 2; i < 21; ++i) {
+        QCOMPARE(reader.readValue(), QJsonValue(QJsonValue::Undefined));
+        QCOMPARE(reader.error(), QJsonParseError::PrematureEndOfDocument);
+        QCOMPARE(reader.tokenType(), QJsonStreamReader::StartArray);
+        reader.addData(json.mid(i, 1));
+    }
+    reader.addData(json.mid(21));
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonArray{ 1, 2, QJsonObject{ { "x", "]\"]" } } }));
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), 3);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+
+    // the same, refilling the buffer from a device one byte at a time while
+    // looking for the end of the container
+    QByteArray data = json;
+    SequentialBuffer device(&data, 1);
+    QVERIFY(device.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+    reader.setDevice(&device);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonArray{ 1, 2, QJsonObject{ { "x", "]\"]" } } }));
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+
+    // an escaped quote at the start of a chunk does not end the string
+    data = "[\"a\\\"]\"]";
+    QVERIFY(device.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+    reader.setDevice(&device);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonArray{ "a\"]" }));
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+}
+
+void tst_QJsonStream::errors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonParseError::ParseError>("error");
+    QTest::addColumn<qint64>("offset");
+
+    QTest::newRow("unterminatedArray") << QByteArray("[1") << QJsonParseError::PrematureEndOfDocument << qint64(1);
+    QTest::newRow("unterminatedString") << QByteArray("[\"abc") << QJsonParseError::PrematureEndOfDocument << qint64(1);
+    QTest::newRow("partialLiteral") << QByteArray("[tru") << QJsonParseError::PrematureEndOfDocument << qint64(1);
+    QTest::newRow("badLiteral") << QByteArray("[trux]") << QJsonParseError::IllegalValue << qint64(1);
+    QTest::newRow("illegalValue") << QByteArray("[x]") << QJsonParseError::IllegalValue << qint64(1);
+    QTest::newRow("illegalNumber") << QByteArray("[01]") << QJsonParseError::IllegalNumber << qint64(1);
+    QTest::newRow("illegalNumber2") << QByteArray("[1.e5]") << QJsonParseError::IllegalNumber << qint64(1);
+    QTest::newRow("missingComma") << QByteArray("[1 2]") << QJsonParseError::MissingValueSeparator << qint64(3);
+    QTest::newRow("trailingComma") << QByteArray("[1,]") << QJsonParseError::MissingObject << qint64(3);
+    QTest::newRow("missingColon") << QByteArray("{\"a\" 1}") << QJsonParseError::MissingNameSeparator << qint64(5);
+    QTest::newRow("nameNotString") << QByteArray("{1:2}") << QJsonParseError::UnterminatedObject << qint64(1);
+    QTest::newRow("trailingCommaObject") << QByteArray("{\"a\":1,}") << QJsonParseError::MissingObject << qint64(7);
+    QTest::newRow("mismatched") << QByteArray("{\"a\":1]") << QJsonParseError::UnterminatedObject << qint64(6);
+    QTest::newRow("illegalEscape") << QByteArray("[\"\\u12x4\"]") << QJsonParseError::IllegalEscapeSequence << qint64(1);
+    QTest::newRow("illegalUtf8") << QByteArray("[\"\xff\"]") << QJsonParseError::IllegalUTF8String << qint64(1);
+    QTest::newRow("deepNesting") << QByteArray(1025, '[') << QJsonParseError::DeepNesting << qint64(1024);
+    QTest::newRow("literalAfterLiteral") << QByteArray("truefalse") << QJsonParseError::GarbageAtEnd << qint64(4);
+    QTest::newRow("nullAfterNull") << QByteArray("nullnull") << QJsonParseError::GarbageAtEnd << qint64(4);
+    QTest::newRow("stringAfterNumber") << QByteArray("1\"x\"") << QJsonParseError::GarbageAtEnd << qint64(1);
+    QTest::newRow("objectAfterArray") << QByteArray("[]{}") << QJsonParseError::GarbageAtEnd << qint64(2);
+    QTest::newRow("numberAfterString") << QByteArray("\"x\"1") << QJsonParseError::GarbageAtEnd << qint64(3);
+}
+
+void tst_QJsonStream::errors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonParseError::ParseError, error);
+    QFETCH(qint64, offset);
+
+    QJsonStreamReader reader(json);
+    TokenList tokens;
+    QCOMPARE(readAll(reader, &tokens), QJsonStreamReader::Invalid);
+    QVERIFY(reader.hasError());
+    QCOMPARE(reader.error(), error);
+    QCOMPARE(reader.currentOffset(), offset);
+    QVERIFY(!reader.errorString().isEmpty());
+
+    // fatal errors are sticky
+    if (error != QJsonParseError::PrematureEndOfDocument) {
+        reader.addData("]");
+        QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+        QCOMPARE(reader.error(), error);
+    }
+}
+
+void tst_QJsonStream::writer_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("emptyArray") << QByteArray("[]");
+    QTest::newRow("emptyObject") << QByteArray("{}");
+    QTest::newRow("nested")
+            << QByteArray("{\"a\": [1, 2.5, \"x\\u0001\\\"\", true, null, [], {}], "
+                          "\"b\": {\"c\": [[{\"d\": false}]]}, \"e\": \"\xe2\x82\xac\"}");
+}
+
+// writes the document one token at a time, using writeValue() for scalars only
+static void writeTokens(QJsonStreamWriter &writer, const QJsonValue &value)
+{
+    if (value.isArray()) {
+        writer.writeStartArray();
+        const QJsonArray array = value.toArray();
+        for (const QJsonValue &v : array)
+            writeTokens(writer, v);
+        writer.writeEndArray();
+    } else if (value.isObject()) {
+        writer.writeStartObject();
+        const QJsonObject object = value.toObject();
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            writer.writeName(it.key());
+            writeTokens(writer, it.value());
+        }
+        writer.writeEndObject();
+    } else {
+        writer.writeValue(value);
+    }
+}
+
+void tst_QJsonStream::writer()
+{
+    QFETCH(QByteArray, json);
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+    QVERIFY(!doc.isNull());
+    const QJsonValue value = doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object());
+
+    for (auto format : { QJsonDocument::Compact, QJsonDocument::Indented }) {
+        QByteArray tokens;
+        {
+            QJsonStreamWriter writer(&tokens);
+            writer.setFormat(format);
+            writeTokens(writer, value);
+            QCOMPARE(writer.depth(), 0);
+        }
+        QCOMPARE(tokens, doc.toJson(format));
+
+        QByteArray whole;
+        {
+            QJsonStreamWriter writer(&whole);
+            writer.setFormat(format);
+            writer.writeValue(value);
+        }
+        QCOMPARE(whole, doc.toJson(format));
+
+        // nested containers written with writeValue() inside streamed ones
+        QByteArray mixed;
+        {
+            QJsonStreamWriter writer(&mixed);
+            writer.setFormat(format);
+            writer.writeStartArray();
+            writer.writeValue(value);
+            writer.writeStartObject();
+            writer.writeMember(u"v", value);
+            writer.writeEndObject();
+            writer.writeEndArray();
+        }
+        QJsonArray expected{ value, QJsonObject{ { "v", value } } };
+        QCOMPARE(mixed, QJsonDocument(expected).toJson(format));
+    }
+}
+
+void tst_QJsonStream::writerMultipleTopLevelValues()
+{
+    QByteArray json;
+    QJsonStreamWriter writer(&json);
+    writer.writeStartObject();
+    writer.writeMember(u"id", 1);
+    writer.writeEndObject();
+    writer.writeValue(QJsonArray{ 2 });
+    writer.writeValue(QLatin1String("three"));
+    QCOMPARE(json, QByteArray("{\"id\":1}\n[2]\n\"three\""));
+
+    // and read them back
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonObject{ { "id", 1 } }));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonArray{ 2 }));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), QLatin1String("three"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+}
+
+void tst_QJsonStream::writerDevice()
+{
+    QJsonArray array;
+    for (int i = 0; i < 10000; ++i)
+        array.append(QJsonObject{ { "i", i }, { "s", QString::number(i) } });
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    {
+        QJsonStreamWriter writer(&buffer);
+        QCOMPARE(writer.device(), &buffer);
+        writeTokens(writer, array);
+        QVERIFY(!writer.hasError());
+    }
+    QCOMPARE(buffer.data(), QJsonDocument(array).toJson(QJsonDocument::Compact));
+
+    QBuffer readOnly;
+    QVERIFY(readOnly.open(QIODevice::ReadOnly));
+    QJsonStreamWriter writer(&readOnly);
+    QTest::ignoreMessage(QtWarningMsg, "QIODevice::write (QBuffer): ReadOnly device");
+    writer.writeValue(1);
+    QVERIFY(writer.hasError());
+}
+
+QTEST_MAIN(tst_QJsonStream)
+
+#include "tst_qjsonstream.moc"
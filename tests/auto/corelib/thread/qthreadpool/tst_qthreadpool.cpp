@@ -38,6 +38,9 @@
 #ifdef Q_OS_UNIX
 #include <unistd.h>
 #endif
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#include <sched.h>
+#endif
 
 typedef void (*FunctionPointer)();
 
@@ -105,6 +108,10 @@ private slots:
     void stressTest();
     void takeAllAndIncreaseMaxThreadCount();
     void waitForDoneAfterTake();
+    void workStealing();
+    void workStealingPriority();
+    void workStealingIdleThreadSteals();
+    void affinity();
 
 private:
     QMutex m_functionTestMutex;
@@ -1325,5 +1332,223 @@ void tst_QThreadPool::waitForDoneAfterTake()
 
 }
 
+void tst_QThreadPool::workStealing()
+{
+    QThreadPool threadPool;
+    QVERIFY(!threadPool.isWorkStealingEnabled());
+    threadPool.setWorkStealingEnabled(true);
+    QVERIFY(threadPool.isWorkStealingEnabled());
+    threadPool.setMaxThreadCount(4);
+
+    // every runnable starts four more, down to the given depth
+    QAtomicInt count;
+    std::function<void(int)> spawn = [&](int depth) {
+        count.ref();
+        if (depth == 0)
+            return;
+        for (int i = 0; i < 4; ++i)
+            threadPool.start([&spawn, depth] { spawn(depth - 1); });
+    };
+    threadPool.start([&spawn] { spawn(6); });
+
+    QVERIFY(threadPool.waitForDone(60000));
+    QCOMPARE(count.loadRelaxed(), 1 + 4 + 16 + 64 + 256 + 1024 + 4096);
+}
+
+void tst_QThreadPool::workStealingPriority()
+{
+    QThreadPool threadPool;
+    threadPool.setWorkStealingEnabled(true);
+    threadPool.setMaxThreadCount(1); // the pool's only thread is busy when starting
+
+    QList<int> order;
+    QAtomicInt deleted;
+    class Counted : public QRunnable
+    {
+    public:
+        QAtomicInt &deleted;
+        Counted(QAtomicInt &deleted) : deleted(deleted) {}
+        ~Counted() { deleted.ref(); }
+        void run() override {}
+    };
+
+    threadPool.start([&] {
+        for (int priority : { 0, 5, 1, 5 })
+            threadPool.start([&order, priority] { order.append(priority); }, priority);
+    });
+    QVERIFY(threadPool.waitForDone(10000));
+    QCOMPARE(order, QList<int>({ 5, 5, 1, 0 }));
+
+    // runnables queued by the thread itself can still be taken or cleared
+    bool taken = false;
+    int deletedByClear = 0;
+    threadPool.start([&] {
+        QScopedPointer<QRunnable> runnable(createTask(emptyFunct));
+        runnable->setAutoDelete(false);
+        threadPool.start(runnable.get());
+        taken = threadPool.tryTake(runnable.get());
+
+        threadPool.start(new Counted(deleted), 10);
+        threadPool.start(new Counted(deleted), -10);
+        threadPool.clear();
+        deletedByClear = deleted.loadRelaxed();
+    });
+    QVERIFY(threadPool.waitForDone(10000));
+    QVERIFY(taken);
+    QCOMPARE(deletedByClear, 2);
+
+    // the thread prefers runnables with a higher priority from the global
+    // queue over its local ones
+    order.clear();
+    QSemaphore localQueued;
+    QSemaphore globalQueued;
+    threadPool.start([&] {
+        for (int priority : { 0, 10 })
+            threadPool.start([&order, priority] { order.append(priority); }, priority);
+        localQueued.release();
+        globalQueued.acquire();
+    });
+    localQueued.acquire();
+    threadPool.start([&order] { order.append(5); }, 5);
+    globalQueued.release();
+    QVERIFY(threadPool.waitForDone(10000));
+    QCOMPARE(order, QList<int>({ 10, 5, 0 }));
+}
+
+void tst_QThreadPool::workStealingIdleThreadSteals()
+{
+    QThreadPool threadPool;
+    threadPool.setWorkStealingEnabled(true);
+    threadPool.setMaxThreadCount(2);
+
+    QSemaphore holderStarted;
+    QSemaphore releaseHolder;
+    QSemaphore childDone;
+    QThread *parentThread = nullptr;
+    QThread *childThread = nullptr;
+    bool childRan = false;
+
+    threadPool.start([&] {
+        parentThread = QThread::currentThread();
+
+        // occupy the other thread, so that the child gets queued locally
+        threadPool.start([&] {
+            holderStarted.release();
+            releaseHolder.acquire();
+        });
+        holderStarted.acquire();
+
+        threadPool.start([&] {
+            childThread = QThread::currentThread();
+            childDone.release();
+        });
+        releaseHolder.release();
+
+        // only the other thread can run the child now
+        childRan = childDone.tryAcquire(1, 10000);
+    });
+
+    QVERIFY(threadPool.waitForDone(20000));
+    QVERIFY(childRan);
+    QVERIFY(childThread);
+    QVERIFY(childThread != parentThread);
+}
+
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+static QList<int> currentThreadCpus()
+{
+    QList<int> cpus;
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set))
+                cpus.append(cpu);
+        }
+    }
+    return cpus;
+}
+#endif
+
+void tst_QThreadPool::affinity()
+{
+    QThreadPool threadPool;
+    QCOMPARE(threadPool.affinityPolicy(), QThreadPool::SharedAffinity);
+    QVERIFY(threadPool.cpuAffinity().isEmpty());
+
+    QVERIFY(QThreadPool::numaNodeCount() >= 1);
+    QList<int> allCpus;
+    for (int node = 0; node < QThreadPool::numaNodeCount(); ++node) {
+        const QList<int> cpus = QThreadPool::numaNodeCpus(node);
+        QVERIFY(!cpus.isEmpty());
+        allCpus += cpus;
+    }
+    QVERIFY(QThreadPool::numaNodeCpus(QThreadPool::numaNodeCount()).isEmpty());
+
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+    std::sort(allCpus.begin(), allCpus.end());
+    QCOMPARE(allCpus, currentThreadCpus());
+    if (allCpus.size() < 2)
+        QSKIP("This test needs at least two CPUs");
+
+    // runs a runnable on each of the pool's two threads at the same time and
+    // returns the CPUs each of the threads may run on
+    threadPool.setMaxThreadCount(2);
+    const auto poolThreadCpus = [&threadPool] {
+        QMutex mutex;
+        QList<QList<int>> threadCpus;
+        QSemaphore arrived;
+        QSemaphore proceed;
+        for (int i = 0; i < 2; ++i) {
+            threadPool.start([&] {
+                {
+                    QMutexLocker locker(&mutex);
+                    threadCpus.append(currentThreadCpus());
+                }
+                arrived.release();
+                proceed.acquire();
+            });
+        }
+        const bool bothRunning = arrived.tryAcquire(2, 10000);
+        proceed.release(2);
+        return (bothRunning && threadPool.waitForDone(10000)) ? threadCpus : QList<QList<int>>();
+    };
+
+    // restrict all threads to the last two CPUs
+    const QList<int> lastCpus = allCpus.mid(allCpus.size() - 2);
+    threadPool.setCpuAffinity(lastCpus);
+    QCOMPARE(threadPool.cpuAffinity(), lastCpus);
+    QList<QList<int>> threadCpus = poolThreadCpus();
+    QCOMPARE(threadCpus, QList<QList<int>>(2, lastCpus));
+
+    // one core per thread: the two CPUs form either one core, shared by both
+    // threads, or two cores, one for each thread
+    threadPool.setAffinityPolicy(QThreadPool::PerCoreAffinity);
+    QCOMPARE(threadPool.affinityPolicy(), QThreadPool::PerCoreAffinity);
+    threadCpus = poolThreadCpus();
+    QCOMPARE(threadCpus.size(), 2);
+    if (threadCpus.first() != threadCpus.last()) {
+        std::sort(threadCpus.begin(), threadCpus.end());
+        QCOMPARE(threadCpus, QList<QList<int>>({ { lastCpus.first() }, { lastCpus.last() } }));
+    } else {
+        QCOMPARE(threadCpus.first(), lastCpus);
+    }
+
+    // one node per thread, on all of the node's CPUs
+    threadPool.setCpuAffinity({});
+    threadPool.setAffinityPolicy(QThreadPool::PerNodeAffinity);
+    QCOMPARE(threadPool.affinityPolicy(), QThreadPool::PerNodeAffinity);
+    threadCpus = poolThreadCpus();
+    QCOMPARE(threadCpus.size(), 2);
+    for (const QList<int> &cpus : qAsConst(threadCpus)) {
+        bool isNode = false;
+        for (int node = 0; node < QThreadPool::numaNodeCount(); ++node)
+            isNode = isNode || cpus == QThreadPool::numaNodeCpus(node);
+        QVERIFY(isNode);
+    }
+    if (QThreadPool::numaNodeCount() > 1)
+        QVERIFY(threadCpus.first() != threadCpus.last());
+#endif
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
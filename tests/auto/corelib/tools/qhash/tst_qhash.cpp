@@ -77,11 +77,16 @@ private slots:
     void emplace();
 
     void badHashFunction();
+    void reserveShared();
     void hashOfHash();
 
     void stdHash();
 
     void countInEmptyHash();
+
+    void hashedLookup();
+    void insertHashedFromSelf();
+    void multiHashHashedLookup();
 };
 
 struct IdentityTracker {
@@ -1889,6 +1894,30 @@ void tst_QHash::badHashFunction()
 
 }
 
+void tst_QHash::reserveShared()
+{
+    // reserving on a shared hash copies it into a different number of buckets
+    QHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    const QHash<int, int> copy = hash;
+
+    // grow
+    hash.reserve(1000);
+    QVERIFY(!hash.isSharedWith(copy));
+    QVERIFY(hash.capacity() >= 1000);
+    QCOMPARE(hash, copy);
+
+    // shrink
+    const QHash<int, int> large = hash;
+    hash.reserve(200);
+    QVERIFY(!hash.isSharedWith(large));
+    QVERIFY(hash.capacity() < large.capacity());
+    QCOMPARE(hash, copy);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+}
+
 void tst_QHash::hashOfHash()
 {
     QHash<int, int> hash;
@@ -1993,5 +2022,125 @@ void tst_QHash::countInEmptyHash()
     }
 }
 
+void tst_QHash::hashedLookup()
+{
+    QHash<QString, int> hash;
+    QStringList keys;
+    QList<size_t> hashes;
+    for (int i = 0; i < 1000; ++i) {
+        keys << QString::number(i).repeated(10);
+        hashes << hash.hashKey(keys.last());
+    }
+
+    // a hash computed before the data is allocated stays valid
+    for (int i = 0; i < 1000; ++i) {
+        auto it = hash.insertHashed(keys.at(i), hashes.at(i), i);
+        QCOMPARE(it.key(), keys.at(i));
+        QCOMPARE(it.value(), i);
+        QCOMPARE(hash.hashKey(keys.at(i)), hashes.at(i));
+    }
+    QCOMPARE(hash.size(), 1000);
+    hash.insertHashed(keys.at(0), hashes.at(0), -1);
+    QCOMPARE(hash.size(), 1000);
+    QCOMPARE(hash.value(keys.at(0)), -1);
+
+    for (int i = 1; i < 1000; ++i) {
+        QVERIFY(hash.containsHashed(keys.at(i), hashes.at(i)));
+        QCOMPARE(hash.constFindHashed(keys.at(i), hashes.at(i)).value(), i);
+        QCOMPARE(hash.findHashed(keys.at(i), hashes.at(i)), hash.find(keys.at(i)));
+    }
+
+    const QString missing = QStringLiteral("missing");
+    const size_t missingHash = hash.hashKey(missing);
+    QVERIFY(!hash.containsHashed(missing, missingHash));
+    QCOMPARE(hash.constFindHashed(missing, missingHash), hash.constEnd());
+    QCOMPARE(hash.findHashed(missing, missingHash), hash.end());
+
+    // other hashes use the same seed
+    QHash<QString, int> copy;
+    for (int i = 0; i < 1000; ++i)
+        copy.insertHashed(keys.at(i), hashes.at(i), i);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(copy.value(keys.at(i), -2), i);
+
+    // shared null
+    const QHash<QString, int> empty;
+    QVERIFY(!empty.containsHashed(missing, missingHash));
+    QCOMPARE(empty.findHashed(missing, missingHash), empty.end());
+}
+
+void tst_QHash::insertHashedFromSelf()
+{
+    // std::string is not relocatable, so growing moves from the old nodes
+    // and a dangling reference sees an empty or destroyed string
+    QHash<int, std::string> hash;
+    hash.insertHashed(0, hash.hashKey(0), std::string(100, 'x'));
+    for (int i = 1; i < 1000; ++i) {
+        const std::string &value = *hash.constFind(i - 1);
+        hash.insertHashed(i, hash.hashKey(i), value);
+    }
+    QCOMPARE(hash.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(i), std::string(100, 'x'));
+
+    // the value lives in data shared with another hash
+    QHash<int, std::string> copy = hash;
+    hash.insertHashed(1000, hash.hashKey(1000), *hash.constFind(999));
+    QCOMPARE(hash.value(1000), std::string(100, 'x'));
+    QVERIFY(!copy.contains(1000));
+
+    // replacing a value with the value of the same item
+    hash.insertHashed(0, hash.hashKey(0), *hash.constFind(0));
+    QCOMPARE(hash.value(0), std::string(100, 'x'));
+
+    QMultiHash<int, std::string> multi;
+    multi.insertHashed(0, multi.hashKey(0), std::string(100, 'y'));
+    for (int i = 1; i < 1000; ++i)
+        multi.insertHashed(i, multi.hashKey(i), *multi.constFind(i - 1));
+    QCOMPARE(multi.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(multi.value(i), std::string(100, 'y'));
+}
+
+void tst_QHash::multiHashHashedLookup()
+{
+    QMultiHash<QString, int> hash;
+    QStringList keys;
+    QList<size_t> hashes;
+    for (int i = 0; i < 100; ++i) {
+        keys << QString::number(i).repeated(10);
+        hashes << hash.hashKey(keys.last());
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        hash.insertHashed(keys.at(i), hashes.at(i), i);
+        QCOMPARE(hash.hashKey(keys.at(i)), hashes.at(i));
+    }
+    // inserting an existing key adds another value
+    auto it = hash.insertHashed(keys.at(0), hashes.at(0), -1);
+    QCOMPARE(it.key(), keys.at(0));
+    QCOMPARE(it.value(), -1);
+    QCOMPARE(hash.size(), 101);
+    QCOMPARE(hash.values(keys.at(0)), QList<int>({ -1, 0 }));
+
+    for (int i = 1; i < 100; ++i) {
+        QVERIFY(hash.containsHashed(keys.at(i), hashes.at(i)));
+        QCOMPARE(hash.constFindHashed(keys.at(i), hashes.at(i)).value(), i);
+        QCOMPARE(hash.findHashed(keys.at(i), hashes.at(i)), hash.find(keys.at(i)));
+    }
+    QCOMPARE(hash.constFindHashed(keys.at(0), hashes.at(0)).value(), -1);
+
+    const QString missing = QStringLiteral("missing");
+    const size_t missingHash = hash.hashKey(missing);
+    QVERIFY(!hash.containsHashed(missing, missingHash));
+    QCOMPARE(hash.constFindHashed(missing, missingHash), hash.constEnd());
+    QCOMPARE(hash.findHashed(missing, missingHash), hash.end());
+
+    // shared null
+    const QMultiHash<QString, int> empty;
+    QVERIFY(!empty.containsHashed(missing, missingHash));
+    QCOMPARE(empty.findHashed(missing, missingHash), empty.end());
+}
+
 QTEST_APPLESS_MAIN(tst_QHash)
 #include "tst_qhash.moc"
@@ -0,0 +1,128 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 David Faure <david.faure@kdab.com>
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtconcurrentmap.h>
+
+#include <QTest>
+
+#include <limits>
+#include <numeric>
+
+using namespace QtConcurrent;
+
+class tst_QtConcurrentMap : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mappedReducedOrdered_data();
+    void mappedReducedOrdered();
+};
+
+namespace {
+
+QAtomicInt alive;
+QAtomicInt peak;
+
+// An intermediate result that keeps track of how many of its kind are alive
+struct Counted
+{
+    explicit Counted(int value = 0) : value(value) { add(); }
+    Counted(const Counted &other) : value(other.value) { add(); }
+    Counted &operator=(const Counted &other) = default;
+    ~Counted() { alive.deref(); }
+
+    static void add()
+    {
+        const int count = alive.fetchAndAddRelaxed(1) + 1;
+        int max = peak.loadRelaxed();
+        while (count > max && !peak.testAndSetRelaxed(max, count, max))
+            ;
+    }
+
+    int value;
+};
+
+Counted slowFirst(int x)
+{
+    // keeps the ordered reduction waiting while the other threads map ahead
+    if (x == 0)
+        QThread::msleep(50);
+    return Counted(x & 0xff);
+}
+
+void sum(qint64 &result, const Counted &value)
+{
+    result += value.value;
+}
+
+} // unnamed namespace
+
+void tst_QtConcurrentMap::mappedReducedOrdered_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("bounded");
+
+    for (int count : { 100000, 1000000, 10000000 }) {
+        const QByteArray size = QByteArray::number(count);
+        QTest::newRow(size + " unbounded") << count << false;
+        QTest::newRow(size + " bounded") << count << true;
+    }
+}
+
+// Compares the time and the peak number of pending intermediate results with
+// and without the block size limit of the reducing kernels.
+void tst_QtConcurrentMap::mappedReducedOrdered()
+{
+    QFETCH(int, count);
+    QFETCH(bool, bounded);
+
+    QList<int> list(count);
+    std::iota(list.begin(), list.end(), 0);
+
+    using Reducer = ReduceKernel<decltype(&sum), qint64, Counted>;
+    using Kernel = MappedReducedKernel<qint64, QList<int>::const_iterator, decltype(&slowFirst),
+                                       decltype(&sum), Reducer>;
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    qint64 result = 0;
+    peak.storeRelaxed(0);
+    QBENCHMARK {
+        auto kernel = new Kernel(pool, list.constBegin(), list.constEnd(), slowFirst, sum,
+                                 OrderedReduce);
+        if (!bounded)
+            kernel->blockSizeLimit = std::numeric_limits<int>::max();
+        result = startThreadEngine(kernel).startBlocking();
+    }
+    QVERIFY(result > 0);
+    qDebug("peak pending results: %d", peak.loadRelaxed());
+}
+
+QTEST_MAIN(tst_QtConcurrentMap)
+
+#include "tst_qtconcurrentmap.moc"
@@ -27,6 +27,8 @@
 ****************************************************************************/
 
 #include <QTest>
+#include <qelapsedtimer.h>
+#include <qjsonarray.h>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
 
@@ -45,6 +47,10 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseThroughput_data();
+    void parseThroughput();
+    void loadJsonFile_data();
+    void loadJsonFile();
 
     void jsonObjectInsert();
     void variantMapInsert();
@@ -117,6 +123,78 @@ void BenchmarkQtJson::parseJsonToVariant()
     }
 }
 
+void BenchmarkQtJson::parseThroughput_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QTest::newRow("test.json") << file.readAll();
+
+    // a few MB of records with mostly string contents
+    QJsonArray records;
+    for (int i = 0; i < 20000; ++i) {
+        records.append(QJsonObject{
+            { "id", i },
+            { "name", QString("record number %1").arg(i) },
+            { "description", QString("a longer piece of text that describes record %1, "
+                                     "as found in configuration files and logs").arg(i) },
+            { "path", QString("/usr/share/application/data/%1/contents.json").arg(i) },
+            { "tags", QJsonArray{ "alpha", "beta", "gamma" } },
+            { "enabled", i % 2 == 0 }
+        });
+    }
+    QTest::newRow("records-compact") << QJsonDocument(records).toJson(QJsonDocument::Compact);
+    QTest::newRow("records-indented") << QJsonDocument(records).toJson(QJsonDocument::Indented);
+}
+
+// Reports bytes of JSON parsed per second.
+void BenchmarkQtJson::parseThroughput()
+{
+    QFETCH(QByteArray, json);
+
+    QElapsedTimer timer;
+    qint64 bytes = 0;
+    timer.start();
+    do {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+        QVERIFY(!doc.isNull());
+        bytes += json.size();
+    } while (timer.elapsed() < 1000);
+
+    const qreal bytesPerSecond = bytes * 1e9 / timer.nsecsElapsed();
+    qInfo("%s: %.3f GB/s", QTest::currentDataTag(), bytesPerSecond / 1e9);
+    QTest::setBenchmarkResult(bytesPerSecond, QTest::BytesPerSecond);
+}
+
+void BenchmarkQtJson::loadJsonFile_data()
+{
+    QTest::addColumn<bool>("mapped");
+    QTest::newRow("readAll+fromJson") << false;
+    QTest::newRow("fromJsonFile") << true;
+}
+
+void BenchmarkQtJson::loadJsonFile()
+{
+    QFETCH(bool, mapped);
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+
+    QBENCHMARK {
+        QJsonDocument doc;
+        if (mapped) {
+            doc = QJsonDocument::fromJsonFile(testFile);
+        } else {
+            QFile file(testFile);
+            file.open(QFile::ReadOnly);
+            doc = QJsonDocument::fromJson(file.readAll());
+        }
+        QJsonObject object = doc.object();
+    }
+}
+
 void BenchmarkQtJson::jsonObjectInsert()
 {
     QJsonObject object;
@@ -30,6 +30,10 @@
 #include <qtest.h>
 #include <qtesteventloop.h>
 
+#ifdef Q_OS_UNIX
+#  include <unistd.h>
+#endif
+
 class PingPong : public QObject
 {
 public:
@@ -83,6 +87,19 @@ int EventTester::foo(int bar)
     return bar + 1;
 }
 
+class CallCounter : public QObject
+{
+public:
+    int count = 0;
+    int expected = 0;
+
+    void increment()
+    {
+        if (++count == expected)
+            QTestEventLoop::instance().exitLoop();
+    }
+};
+
 class EventsBench : public QObject
 {
     Q_OBJECT
@@ -96,6 +113,14 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+#if QT_CONFIG(cxx11_future)
+    void multiProducerInvokeMethod_data();
+    void multiProducerInvokeMethod();
+#endif
+#ifdef Q_OS_UNIX
+    void idleSocketNotifiers_data();
+    void idleSocketNotifiers();
+#endif
 };
 
 void EventsBench::initTestCase()
@@ -169,6 +194,104 @@ void EventsBench::postEvent()
     }
 }
 
+#if QT_CONFIG(cxx11_future)
+void EventsBench::multiProducerInvokeMethod_data()
+{
+    QTest::addColumn<int>("producers");
+    QTest::newRow("1") << 1;
+    QTest::newRow("4") << 4;
+    QTest::newRow("16") << 16;
+}
+
+// Measures queued calls made concurrently by several threads to one receiver,
+// which all go through the posted-event queue of the receiver's thread.
+void EventsBench::multiProducerInvokeMethod()
+{
+    QFETCH(int, producers);
+    static const int callsPerProducer = 20000;
+    CallCounter counter;
+
+    QBENCHMARK {
+        counter.count = 0;
+        counter.expected = producers * callsPerProducer;
+        QList<QThread *> threads;
+        for (int i = 0; i < producers; ++i) {
+            threads << QThread::create([&counter] {
+                for (int j = 0; j < callsPerProducer; ++j) {
+                    QMetaObject::invokeMethod(&counter, [&counter] { counter.increment(); },
+                                              Qt::QueuedConnection);
+                }
+            });
+            threads.last()->start();
+        }
+        QTestEventLoop::instance().enterLoop(60);
+        for (QThread *t : qAsConst(threads))
+            t->wait();
+        qDeleteAll(threads);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        QCOMPARE(counter.count, counter.expected);
+    }
+}
+#endif
+
+#ifdef Q_OS_UNIX
+void EventsBench::idleSocketNotifiers_data()
+{
+    QTest::addColumn<int>("idleCount");
+    QTest::newRow("0") << 0;
+    QTest::newRow("100") << 100;
+    QTest::newRow("900") << 900;
+}
+
+// Measures one event loop iteration delivering a single socket activation
+// while many other registered socket notifiers stay idle. Run with
+// QT_EVENT_DISPATCHER_EPOLL=1 to compare against the epoll dispatcher.
+void EventsBench::idleSocketNotifiers()
+{
+    QFETCH(int, idleCount);
+
+    int idlePipe[2];
+    int activePipe[2];
+    QVERIFY(::pipe(idlePipe) == 0);
+    QVERIFY(::pipe(activePipe) == 0);
+
+    QList<int> idleFds;
+    QList<QSocketNotifier *> idleNotifiers;
+    for (int i = 0; i < idleCount; ++i) {
+        const int fd = ::dup(idlePipe[0]);
+        if (fd == -1)
+            break;
+        idleFds << fd;
+        idleNotifiers << new QSocketNotifier(fd, QSocketNotifier::Read);
+    }
+
+    if (idleFds.count() == idleCount) {
+        QSocketNotifier active(activePipe[0], QSocketNotifier::Read);
+        int activations = 0;
+        connect(&active, &QSocketNotifier::activated, [&](QSocketDescriptor fd) {
+            char c;
+            if (::read(fd, &c, 1) == 1)
+                ++activations;
+        });
+
+        QBENCHMARK {
+            QVERIFY(::write(activePipe[1], "x", 1) == 1);
+            QCoreApplication::processEvents();
+        }
+        QVERIFY(activations > 0);
+    }
+
+    qDeleteAll(idleNotifiers);
+    for (int fd : qAsConst(idleFds))
+        ::close(fd);
+    for (int fd : { idlePipe[0], idlePipe[1], activePipe[0], activePipe[1] })
+        ::close(fd);
+
+    if (idleFds.count() != idleCount)
+        QSKIP("Not enough file descriptors available");
+}
+#endif
+
 QTEST_MAIN(EventsBench)
 
 #include "main.moc"
@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QObject>
+#include <QTest>
+
+#include <private/qtimerinfo_unix_p.h>
+
+class TimerReceiver : public QObject
+{
+public:
+    int count = 0;
+
+protected:
+    void timerEvent(QTimerEvent *) override { ++count; }
+};
+
+class tst_QTimerInfo : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void registerUnregister_data() { addData(); }
+    void registerUnregister();
+    void restart_data() { addData(); }
+    void restart();
+    void activate_data() { addData(); }
+    void activate();
+
+private:
+    void addData();
+};
+
+void tst_QTimerInfo::addData()
+{
+    QTest::addColumn<bool>("wheel");
+    QTest::addColumn<int>("count");
+    QTest::newRow("list-1000") << false << 1000;
+    QTest::newRow("list-10000") << false << 10000;
+    QTest::newRow("list-100000") << false << 100000;
+    QTest::newRow("wheel-1000") << true << 1000;
+    QTest::newRow("wheel-10000") << true << 10000;
+    QTest::newRow("wheel-100000") << true << 100000;
+}
+
+// idle timeouts of 10 to 60 seconds, as used for network connections
+static qint64 intervalFor(int i)
+{
+    return 10000 + (i * 37) % 50000;
+}
+
+template <typename Timers>
+static void registerAndUnregisterAll(Timers &timers, QObject *receiver, int count)
+{
+    for (int i = 1; i <= count; ++i)
+        timers.registerTimer(i, intervalFor(i), Qt::CoarseTimer, receiver);
+    for (int i = 1; i <= count; ++i)
+        timers.unregisterTimer(i);
+}
+
+template <typename Timers>
+static void restartAll(Timers &timers, QObject *receiver, int count)
+{
+    // every timer gets restarted once, like an idle timeout on activity
+    for (int i = 1; i <= count; ++i) {
+        timers.unregisterTimer(i);
+        timers.registerTimer(i, intervalFor(i), Qt::CoarseTimer, receiver);
+    }
+}
+
+template <typename Timers>
+static void registerAll(Timers &timers, QObject *receiver, int count)
+{
+    for (int i = 1; i <= count; ++i)
+        timers.registerTimer(i, intervalFor(i), Qt::CoarseTimer, receiver);
+}
+
+void tst_QTimerInfo::registerUnregister()
+{
+    QFETCH(bool, wheel);
+    QFETCH(int, count);
+    TimerReceiver receiver;
+
+    if (wheel) {
+        QTimerWheel timers;
+        QBENCHMARK {
+            registerAndUnregisterAll(timers, &receiver, count);
+        }
+    } else {
+        QTimerInfoList timers;
+        QBENCHMARK {
+            registerAndUnregisterAll(timers, &receiver, count);
+        }
+    }
+}
+
+void tst_QTimerInfo::restart()
+{
+    QFETCH(bool, wheel);
+    QFETCH(int, count);
+    TimerReceiver receiver;
+
+    if (wheel) {
+        QTimerWheel timers;
+        registerAll(timers, &receiver, count);
+        QBENCHMARK {
+            restartAll(timers, &receiver, count);
+        }
+    } else {
+        QTimerInfoList timers;
+        registerAll(timers, &receiver, count);
+        QBENCHMARK {
+            restartAll(timers, &receiver, count);
+        }
+        qDeleteAll(timers);
+    }
+}
+
+// one event loop iteration with many pending, but no due timers
+void tst_QTimerInfo::activate()
+{
+    QFETCH(bool, wheel);
+    QFETCH(int, count);
+    TimerReceiver receiver;
+    timespec tm;
+
+    if (wheel) {
+        QTimerWheel timers;
+        registerAll(timers, &receiver, count);
+        QBENCHMARK {
+            timers.timerWait(tm);
+            timers.activateTimers();
+        }
+    } else {
+        QTimerInfoList timers;
+        registerAll(timers, &receiver, count);
+        QBENCHMARK {
+            timers.timerWait(tm);
+            timers.activateTimers();
+        }
+        qDeleteAll(timers);
+    }
+    QCOMPARE(receiver.count, 0);
+}
+
+QTEST_MAIN(tst_QTimerInfo)
+
+#include "main.moc"
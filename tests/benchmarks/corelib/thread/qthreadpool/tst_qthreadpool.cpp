@@ -40,6 +40,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void manySmallTasks_data();
+    void manySmallTasks();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +77,51 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+void tst_QThreadPool::manySmallTasks_data()
+{
+    QTest::addColumn<bool>("workStealing");
+    QTest::addColumn<int>("threadCount");
+
+    QList<int> threadCounts = { 1, 2, 4 };
+    for (int count = 8; count <= QThread::idealThreadCount(); count *= 2)
+        threadCounts << count;
+
+    for (int count : qAsConst(threadCounts)) {
+        QTest::addRow("queue-%d", count) << false << count;
+        QTest::addRow("stealing-%d", count) << true << count;
+    }
+}
+
+// Each thread of the pool starts many tiny runnables, as done when
+// recursively splitting work.
+void tst_QThreadPool::manySmallTasks()
+{
+    QFETCH(bool, workStealing);
+    QFETCH(int, threadCount);
+
+    const int tasksPerThread = 10000;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+
+    QBENCHMARK {
+        QAtomicInt remaining(threadCount * (tasksPerThread + 1));
+        QSemaphore done;
+        auto task = [&] {
+            if (remaining.fetchAndSubRelaxed(1) == 1)
+                done.release();
+        };
+        for (int i = 0; i < threadCount; ++i) {
+            threadPool.start([&] {
+                for (int j = 0; j < tasksPerThread; ++j)
+                    threadPool.start(task);
+                task();
+            });
+        }
+        done.acquire();
+    }
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
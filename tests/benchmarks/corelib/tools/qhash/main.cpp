@@ -61,6 +61,11 @@ private slots:
     void hashing_javaString_data() { data(); }
     void hashing_javaString() { hashing_template<JavaString>(); }
 
+    void lookup_data() { data(); }
+    void lookup();
+    void lookup_hashed_data() { data(); }
+    void lookup_hashed();
+
 private:
     void data();
     template <typename String> void qhash_template();
@@ -168,6 +173,54 @@ template <typename String> void tst_QHash::hashing_template()
     }
 }
 
+static QStringList longKeys(const QStringList &items)
+{
+    // symbol table style keys, long enough for hashing to dominate lookups
+    QStringList keys;
+    keys.reserve(items.size());
+    for (const QString &s : items)
+        keys.append(QLatin1String("qt.symbols.") + s + QLatin1String("::") + s);
+    return keys;
+}
+
+void tst_QHash::lookup()
+{
+    QFETCH(QStringList, items);
+    const QStringList keys = longKeys(items);
+
+    QHash<QString, int> hash;
+    for (int i = 0, n = keys.size(); i != n; ++i)
+        hash.insert(keys.at(i), i);
+
+    int found = 0;
+    QBENCHMARK {
+        for (int i = 0, n = keys.size(); i != n; ++i)
+            found += hash.contains(keys.at(i));
+    }
+    QVERIFY(found > 0);
+}
+
+void tst_QHash::lookup_hashed()
+{
+    QFETCH(QStringList, items);
+    const QStringList keys = longKeys(items);
+
+    QHash<QString, int> hash;
+    QList<size_t> hashes;
+    hashes.reserve(keys.size());
+    for (int i = 0, n = keys.size(); i != n; ++i) {
+        hashes.append(hash.hashKey(keys.at(i)));
+        hash.insertHashed(keys.at(i), hashes.at(i), i);
+    }
+
+    int found = 0;
+    QBENCHMARK {
+        for (int i = 0, n = keys.size(); i != n; ++i)
+            found += hash.containsHashed(keys.at(i), hashes.at(i));
+    }
+    QVERIFY(found > 0);
+}
+
 QTEST_MAIN(tst_QHash)
 
 #include "main.moc"